@@ -18,6 +18,7 @@
 
 #include <QApplication>
 #include <QCleanlooksStyle>
+#include <QFileInfo>
 
 #include "CompareDescriptorsWidget.h"
 
@@ -29,12 +30,36 @@ int main( int argc, char** argv )
 
   CompareDescriptorsWidget compareDescriptorsWidget;
 
-  if(argc == 2)
+  // Usage: CompareDescriptors [--server serverName] [pointCloud.vtp | image]
+  std::string fileName;
+  for(int i = 1; i < argc; ++i)
+    {
+    std::string argument = argv[i];
+    if(argument == "--server" && i + 1 < argc)
+      {
+      std::string serverName = argv[++i];
+      if(compareDescriptorsWidget.ConnectToServer(serverName))
+        {
+        std::cout << "Connected to " << serverName << std::endl;
+        }
+      }
+    else
+      {
+      fileName = argument;
+      }
+    }
+
+  // Anything that is not a .vtp point cloud is read as an image with a descriptor per pixel.
+  if(QFileInfo(fileName.c_str()).suffix().compare("vtp", Qt::CaseInsensitive) == 0)
     {
-    std::string fileName = argv[1];
     compareDescriptorsWidget.LoadPointCloud(fileName);
     std::cout << "Loaded " << fileName << std::endl;
     }
+  else if(!fileName.empty())
+    {
+    compareDescriptorsWidget.LoadImage(fileName);
+    std::cout << "Loaded " << fileName << std::endl;
+    }
   compareDescriptorsWidget.show();
 
   return app.exec();
@@ -0,0 +1,211 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compare a list of query points to a point cloud and write each colored result to a PNG file, without a display.
+// Each line of the jobs file is a query point id, optionally followed by a camera position, focal point and view up:
+//   queryPointId [positionX positionY positionZ focalPointX focalPointY focalPointZ viewUpX viewUpY viewUpZ]
+
+#include <QtConcurrentRun>
+
+#include <vtkFloatArray.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
+#include <vtkXMLPolyDataReader.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "Helpers.h"
+#include "SnapshotRenderer.h"
+
+static void ComputeJobDifferences(vtkDataArray* const descriptorArray, const vtkIdType queryId,
+                                  vtkFloatArray* const differences)
+{
+  std::vector<double> queryDescriptor(descriptorArray->GetNumberOfComponents());
+  descriptorArray->GetTuple(queryId, &queryDescriptor[0]);
+  Helpers::ComputeDescriptorDifferences(descriptorArray, &queryDescriptor[0], differences);
+}
+
+static bool ReadJobs(const std::string& fileName, std::vector<SnapshotJob>& jobs)
+{
+  std::ifstream fin(fileName.c_str());
+  if(!fin)
+    {
+    std::cerr << "Could not open " << fileName << std::endl;
+    return false;
+    }
+
+  // A typo in an overnight job should stop it rather than silently produce missing or wrong snapshots.
+  std::string line;
+  unsigned int lineNumber = 0;
+  while(getline(fin, line))
+    {
+    lineNumber++;
+    if(line.find_first_not_of(" \t\r") == std::string::npos)
+      {
+      continue; // Skip blank lines.
+      }
+
+    std::stringstream ss(line);
+    SnapshotJob job;
+    if(!(ss >> job.QueryId))
+      {
+      std::cerr << fileName << ":" << lineNumber << ": the line does not start with a query point id." << std::endl;
+      return false;
+      }
+
+    std::vector<double> cameraValues;
+    double value;
+    while(ss >> value)
+      {
+      cameraValues.push_back(value);
+      }
+
+    if(!ss.eof())
+      {
+      std::cerr << fileName << ":" << lineNumber << ": the camera values are not all numbers." << std::endl;
+      return false;
+      }
+
+    if(cameraValues.size() == 9)
+      {
+      std::copy(cameraValues.begin(), cameraValues.begin() + 3, job.Position);
+      std::copy(cameraValues.begin() + 3, cameraValues.begin() + 6, job.FocalPoint);
+      std::copy(cameraValues.begin() + 6, cameraValues.end(), job.ViewUp);
+      job.HasCamera = true;
+      }
+    else if(!cameraValues.empty())
+      {
+      std::cerr << fileName << ":" << lineNumber << ": expected 0 or 9 camera values but found "
+                << cameraValues.size() << "." << std::endl;
+      return false;
+      }
+
+    jobs.push_back(job);
+    }
+
+  return true;
+}
+
+int main( int argc, char** argv )
+{
+  const std::string usage = "Required arguments: pointCloud.vtp arrayName jobs.txt outputPrefix [width height]";
+  if(argc != 5 && argc != 7)
+    {
+    std::cerr << usage << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::string pointCloudFileName = argv[1];
+  std::string arrayName = argv[2];
+  std::string jobsFileName = argv[3];
+  std::string outputPrefix = argv[4];
+
+  unsigned int width = 800;
+  unsigned int height = 600;
+  if(argc == 7)
+    {
+    std::stringstream ss;
+    ss << argv[5] << " " << argv[6];
+    ss >> width >> height;
+
+    // Unsigned extraction accepts a leading minus sign and wraps, so reject one explicitly.
+    std::string sizeArguments = std::string(argv[5]) + argv[6];
+    if(ss.fail() || sizeArguments.find('-') != std::string::npos || width == 0 || height == 0)
+      {
+      std::cerr << usage << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::vector<SnapshotJob> jobs;
+  if(!ReadJobs(jobsFileName, jobs))
+    {
+    return EXIT_FAILURE;
+    }
+
+  vtkSmartPointer<vtkXMLPolyDataReader> reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+  reader->SetFileName(pointCloudFileName.c_str());
+  reader->Update();
+  vtkPolyData* pointCloud = reader->GetOutput();
+
+  vtkDataArray* descriptorArray = pointCloud->GetPointData()->GetArray(arrayName.c_str());
+  if(!descriptorArray)
+    {
+    std::cerr << "Array " << arrayName << " not found!" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  for(unsigned int jobId = 0; jobId < jobs.size(); ++jobId)
+    {
+    if(jobs[jobId].QueryId < 0 || jobs[jobId].QueryId >= pointCloud->GetNumberOfPoints())
+      {
+      std::cerr << "Query point " << jobs[jobId].QueryId << " is out of range." << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  if(jobs.empty())
+    {
+    return EXIT_SUCCESS;
+    }
+
+  SnapshotRenderer snapshotRenderer(width, height);
+  snapshotRenderer.SetPointCloud(pointCloud);
+
+  // Rendering has to happen on this thread, so while a snapshot is rendered the next query is computed
+  // on another thread. The two arrays take turns being rendered and being computed into. They are
+  // allocated here so the computation only writes values and never reallocates.
+  vtkSmartPointer<vtkFloatArray> differences[2];
+  for(unsigned int i = 0; i < 2; ++i)
+    {
+    differences[i] = vtkSmartPointer<vtkFloatArray>::New();
+    differences[i]->SetName("DescriptorDifferences");
+    differences[i]->SetNumberOfComponents(1);
+    differences[i]->SetNumberOfTuples(pointCloud->GetNumberOfPoints());
+    }
+
+  ComputeJobDifferences(descriptorArray, jobs[0].QueryId, differences[0]);
+
+  for(unsigned int jobId = 0; jobId < jobs.size(); ++jobId)
+    {
+    vtkFloatArray* currentDifferences = differences[jobId % 2];
+    vtkFloatArray* nextDifferences = differences[(jobId + 1) % 2];
+
+    QFuture<void> nextComputation;
+    if(jobId + 1 < jobs.size())
+      {
+      nextComputation = QtConcurrent::run(ComputeJobDifferences, descriptorArray, jobs[jobId + 1].QueryId, nextDifferences);
+      }
+
+    std::stringstream ss;
+    ss << outputPrefix << "_" << std::setfill('0') << std::setw(4) << jobId << "_" << jobs[jobId].QueryId << ".png";
+    snapshotRenderer.WriteSnapshot(currentDifferences, jobs[jobId], ss.str());
+    std::cout << "Wrote " << ss.str() << std::endl;
+
+    nextComputation.waitForFinished();
+    }
+
+  return EXIT_SUCCESS;
+}
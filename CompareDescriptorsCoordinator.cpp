@@ -0,0 +1,102 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <QCoreApplication>
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "LocalProcessShardTransport.h"
+#include "ShardCoordinator.h"
+
+int main( int argc, char** argv )
+{
+  const std::string usage = "Required arguments: arrayName queryShardId queryPointId k shard0.vtp [shard1.vtp ...]";
+  if(argc < 6)
+    {
+    std::cerr << usage << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  QCoreApplication app( argc, argv );
+
+  std::string arrayName = argv[1];
+
+  std::stringstream ss;
+  ss << argv[2] << " " << argv[3] << " " << argv[4];
+  unsigned int queryShardId;
+  vtkIdType queryPointId;
+  unsigned int k;
+  ss >> queryShardId >> queryPointId >> k;
+
+  // Unsigned extraction accepts a leading minus sign and wraps, so reject one explicitly.
+  std::string unsignedArguments = std::string(argv[2]) + argv[4];
+  if(ss.fail() || unsignedArguments.find('-') != std::string::npos || queryPointId < 0)
+    {
+    std::cerr << usage << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Start one worker process per shard. The workers are CompareDescriptorsServer instances
+  // that were built next to this executable.
+  std::string serverExecutable = (QCoreApplication::applicationDirPath() + "/CompareDescriptorsServer").toStdString();
+
+  ShardCoordinator coordinator;
+  for(int i = 5; i < argc; ++i)
+    {
+    LocalProcessShardTransport* shard = new LocalProcessShardTransport(serverExecutable, argv[i]);
+    coordinator.AddShard(shard);
+    if(!shard->Start())
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::vector<double> queryDescriptor;
+  if(!coordinator.GetDescriptor(arrayName, queryShardId, queryPointId, queryDescriptor))
+    {
+    return EXIT_FAILURE;
+    }
+
+  DifferenceStatistics statistics;
+  if(!coordinator.ComputeStatistics(arrayName, queryDescriptor, statistics))
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Compared to " << statistics.Count << " points." << std::endl;
+  std::cout << "Range: " << statistics.Minimum << ", " << statistics.Maximum << std::endl;
+  if(statistics.Count > 0)
+    {
+    std::cout << "Mean: " << statistics.Sum / statistics.Count << std::endl;
+    }
+
+  std::vector<ShardMatch> matches;
+  if(!coordinator.FindNearest(arrayName, queryDescriptor, k, matches))
+    {
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "shard pointId difference" << std::endl;
+  for(unsigned int i = 0; i < matches.size(); ++i)
+    {
+    std::cout << matches[i].ShardId << " " << matches[i].Match.Id << " " << matches[i].Match.Difference << std::endl;
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,138 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// Compute a difference image without a display and without loading the whole image.
+// The input is only streamed if its format supports streamed reading (e.g. .mha, .nrrd),
+// and the output is only written in pieces if its format supports streamed writing.
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkRegionOfInterestImageFilter.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+#include "DescriptorDistanceImageFilter.h"
+#include "Types.h"
+
+int main( int argc, char** argv )
+{
+  const std::string usage = "Required arguments: image.mha pixelX pixelY output.mha [numberOfStreamDivisions]";
+  if(argc < 5 || argc > 6)
+    {
+    std::cerr << usage << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::string inputFileName = argv[1];
+  std::string outputFileName = argv[4];
+
+  std::stringstream ss;
+  ss << argv[2] << " " << argv[3];
+  FloatVectorImageType::IndexType selectedPixel;
+  ss >> selectedPixel[0] >> selectedPixel[1];
+  if(ss.fail())
+    {
+    std::cerr << usage << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  unsigned int numberOfStreamDivisions = 1;
+  if(argc > 5)
+    {
+    // Unsigned extraction accepts a leading minus sign and wraps, so reject one explicitly.
+    std::stringstream divisionsStream;
+    divisionsStream << argv[5];
+    divisionsStream >> numberOfStreamDivisions;
+    if(divisionsStream.fail() || std::string(argv[5]).find('-') != std::string::npos || numberOfStreamDivisions == 0)
+      {
+      std::cerr << usage << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+
+  typedef itk::ImageFileReader<FloatVectorImageType> ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(inputFileName);
+  try
+    {
+    reader->UpdateOutputInformation();
+    }
+  catch(itk::ExceptionObject& exception)
+    {
+    std::cerr << "Could not read " << inputFileName << ": " << exception << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  FloatVectorImageType::RegionType largestRegion = reader->GetOutput()->GetLargestPossibleRegion();
+  if(!largestRegion.IsInside(selectedPixel))
+    {
+    std::cerr << "Pixel " << selectedPixel << " is outside of the image " << largestRegion << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Read only the selected pixel to get the query descriptor.
+  FloatVectorImageType::SizeType pixelSize;
+  pixelSize.Fill(1);
+  FloatVectorImageType::RegionType pixelRegion(selectedPixel, pixelSize);
+
+  typedef itk::RegionOfInterestImageFilter<FloatVectorImageType, FloatVectorImageType> RegionOfInterestFilterType;
+  RegionOfInterestFilterType::Pointer regionOfInterestFilter = RegionOfInterestFilterType::New();
+  regionOfInterestFilter->SetRegionOfInterest(pixelRegion);
+  regionOfInterestFilter->SetInput(reader->GetOutput());
+  try
+    {
+    regionOfInterestFilter->Update();
+    }
+  catch(itk::ExceptionObject& exception)
+    {
+    std::cerr << "Could not read the descriptor of pixel " << selectedPixel << ": " << exception << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  FloatVectorImageType::IndexType zeroIndex;
+  zeroIndex.Fill(0);
+  FloatVectorImageType::PixelType queryDescriptor = regionOfInterestFilter->GetOutput()->GetPixel(zeroIndex);
+  std::cout << "Query descriptor: " << queryDescriptor << std::endl;
+
+  typedef DescriptorDistanceImageFilter<FloatVectorImageType, FloatScalarImageType> DistanceFilterType;
+  DistanceFilterType::Pointer distanceFilter = DistanceFilterType::New();
+  distanceFilter->SetInput(reader->GetOutput());
+  distanceFilter->SetQueryDescriptor(queryDescriptor);
+
+  // The writer requests one piece at a time, and each piece is split across threads by the filter.
+  typedef itk::ImageFileWriter<FloatScalarImageType> WriterType;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(outputFileName);
+  writer->SetInput(distanceFilter->GetOutput());
+  writer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  try
+    {
+    writer->Update();
+    }
+  catch(itk::ExceptionObject& exception)
+    {
+    std::cerr << "Could not write " << outputFileName << ": " << exception << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::cout << "Wrote " << outputFileName << std::endl;
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,55 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include <QCoreApplication>
+
+#include <cstdlib>
+#include <iostream>
+
+#include "QueryServer.h"
+
+int main( int argc, char** argv )
+{
+  if(argc < 2)
+    {
+    std::cerr << "Required arguments: serverName [pointCloud.vtp ...]" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  QCoreApplication app( argc, argv );
+
+  QueryServer server;
+
+  // Clouds given on the command line are loaded now, others are loaded when they are first requested.
+  for(int i = 2; i < argc; ++i)
+    {
+    if(!server.LoadPointCloud(argv[i]))
+      {
+      return EXIT_FAILURE;
+      }
+    }
+
+  std::string serverName = argv[1];
+  if(!server.Listen(serverName))
+    {
+    return EXIT_FAILURE;
+    }
+  std::cout << "Listening on " << serverName << std::endl;
+
+  return app.exec();
+}
@@ -19,6 +19,9 @@
 #include "ui_CompareDescriptorsWidget.h"
 #include "CompareDescriptorsWidget.h"
 
+// STL
+#include <algorithm>
+
 // ITK
 #include "itkCastImageFilter.h"
 #include "itkImageFileReader.h"
@@ -28,6 +31,7 @@
 
 // Qt
 #include <QFileDialog>
+#include <QFileInfo>
 #include <QIcon>
 #include <QProgressDialog>
 #include <QTextEdit>
@@ -42,6 +46,8 @@
 #include <vtkFloatArray.h>
 #include <vtkImageActor.h>
 #include <vtkImageData.h>
+#include <vtkImageProperty.h>
+#include <vtkImageSlice.h>
 #include <vtkInteractorStyleImage.h>
 #include <vtkLookupTable.h>
 #include <vtkMath.h>
@@ -63,7 +69,9 @@
 #include <vtkXMLPolyDataWriter.h>
 
 // Custom
+#include "DescriptorDistanceImageFilter.h"
 #include "Helpers.h"
+#include "ITKVTKHelpers.h"
 #include "Types.h"
 #include "PointSelectionStyle3D.h"
 
@@ -73,8 +81,8 @@ void CompareDescriptorsWidget::on_actionHelp_activated()
 
   help->setReadOnly(true);
   help->append("<h1>Compare descriptors</h1>\
-  Load a point cloud <br/>\
-  Ctrl+click to select a point. <br/>\
+  Load a point cloud or an image with a descriptor per pixel. <br/>\
+  Ctrl+click to select a point or pixel. <br/>\
   Click Compare.<br/>"
   );
   help->show();
@@ -86,7 +94,7 @@ void CompareDescriptorsWidget::on_actionQuit_activated()
 }
 
 // Constructor
-CompareDescriptorsWidget::CompareDescriptorsWidget() : MarkerRadius(.05)
+CompareDescriptorsWidget::CompareDescriptorsWidget() : Mode(POINT_CLOUD), UseServer(false), MarkerRadius(.05)
 {
   this->ProgressDialog = new QProgressDialog();
   SharedConstructor();
@@ -119,14 +127,29 @@ void CompareDescriptorsWidget::SharedConstructor()
   this->MarkerActor = vtkSmartPointer<vtkActor>::New();
   this->MarkerActor->SetMapper(this->MarkerMapper);
 
+  // Image
+  this->ImageData = vtkSmartPointer<vtkImageData>::New();
+
+  this->ImageSliceMapper = vtkSmartPointer<vtkImageSliceMapper>::New();
+  this->ImageSliceMapper->SetInputConnection(this->ImageData->GetProducerPort());
+
+  this->ImageSlice = vtkSmartPointer<vtkImageSlice>::New();
+  this->ImageSlice->SetMapper(this->ImageSliceMapper);
+  this->ImageSlice->VisibilityOff();
+
   // Renderer
   this->Renderer = vtkSmartPointer<vtkRenderer>::New();
   this->Renderer->AddActor(this->PointCloudActor);
   this->Renderer->AddActor(this->MarkerActor);
+  this->Renderer->AddViewProp(this->ImageSlice);
 
   this->SelectionStyle = PointSelectionStyle3D::New();
   this->SelectionStyle->AddObserver(this->SelectionStyle->SelectedPointEvent, this, &CompareDescriptorsWidget::SelectedPointCallback);
 
+  this->PixelSelectionStyle = vtkSmartPointer<PixelSelectionStyle2D>::New();
+  this->PixelSelectionStyle->SetImageSlice(this->ImageSlice);
+  this->PixelSelectionStyle->AddObserver(this->PixelSelectionStyle->SelectedPixelEvent, this, &CompareDescriptorsWidget::SelectedPixelCallback);
+
   // Qt things
   this->qvtkWidget->GetRenderWindow()->AddRenderer(this->Renderer);
 
@@ -146,6 +169,14 @@ void CompareDescriptorsWidget::SelectedPointCallback(vtkObject* caller, long uns
   this->MarkerActor->SetPosition(p);
 }
 
+void CompareDescriptorsWidget::SelectedPixelCallback(vtkObject* caller, long unsigned int eventId, void* callData)
+{
+  int ijk[3] = {this->PixelSelectionStyle->SelectedPixel[0], this->PixelSelectionStyle->SelectedPixel[1], 0};
+  double p[3];
+  this->ImageData->GetPoint(this->ImageData->ComputePointId(ijk), p);
+  this->MarkerActor->SetPosition(p);
+}
+
 void CompareDescriptorsWidget::Refresh()
 {
   this->qvtkWidget->GetRenderWindow()->Render();
@@ -158,13 +189,31 @@ void CompareDescriptorsWidget::Refresh()
 
 void CompareDescriptorsWidget::LoadPointCloud(const std::string& fileName)
 {
+  // The server resolves relative paths against its own working directory, so always send an absolute path.
+  this->PointCloudFileName = QFileInfo(fileName.c_str()).absoluteFilePath().toStdString();
+
   vtkSmartPointer<vtkXMLPolyDataReader> reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
-  reader->SetFileName(fileName.c_str());
+  reader->SetFileName(this->PointCloudFileName.c_str());
+
+  // The server holds the descriptors, so only the geometry needs to be read here.
+  if(this->UseServer)
+    {
+    reader->UpdateInformation();
+    for(int i = 0; i < reader->GetNumberOfPointArrays(); ++i)
+      {
+      reader->SetPointArrayStatus(reader->GetPointArrayName(i), 0);
+      }
+    }
 
   reader->Update();
 
   this->PointCloud->DeepCopy(reader->GetOutput());
 
+  this->Mode = POINT_CLOUD;
+  this->ImageSlice->VisibilityOff();
+  this->PointCloudActor->VisibilityOn();
+  this->MarkerSource->SetRadius(this->MarkerRadius);
+
   // Start the computation.
 //   QFuture<void> future = QtConcurrent::run(reader.GetPointer(), static_cast<void(vtkXMLPolyDataReader::*)()>(&vtkXMLPolyDataReader::Update));
 //   this->FutureWatcher.setFuture(future);
@@ -189,7 +238,63 @@ void CompareDescriptorsWidget::LoadPointCloud(const std::string& fileName)
 
   this->Renderer->ResetCamera();
 
-  PopulateArrayNames(this->PointCloud);
+  if(this->UseServer)
+    {
+    PopulateArrayNamesFromServer();
+    }
+  else
+    {
+    PopulateArrayNames(this->PointCloud);
+    }
+}
+
+void CompareDescriptorsWidget::LoadImage(const std::string& fileName)
+{
+  typedef itk::ImageFileReader<FloatVectorImageType> ReaderType;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  try
+    {
+    reader->Update();
+    }
+  catch(itk::ExceptionObject& exception)
+    {
+    std::cerr << "Could not read " << fileName << ": " << exception << std::endl;
+    return;
+    }
+
+  this->Image = reader->GetOutput();
+  this->Image->DisconnectPipeline();
+
+  this->Mode = IMAGE;
+
+  // Until a comparison is made, show the descriptor magnitude in gray.
+  ITKVTKHelpers::ITKVectorImageMagnitudeToVTKImage(this->Image, this->ImageData);
+  this->ImageSlice->GetProperty()->SetLookupTable(NULL);
+
+  // The default window/level is for 8-bit images, which would show typical descriptor magnitudes as black.
+  double magnitudeRange[2];
+  this->ImageData->GetScalarRange(magnitudeRange);
+  double colorWindow = magnitudeRange[1] - magnitudeRange[0];
+  this->ImageSlice->GetProperty()->SetColorWindow(colorWindow > 0 ? colorWindow : 1.0);
+  this->ImageSlice->GetProperty()->SetColorLevel((magnitudeRange[0] + magnitudeRange[1]) / 2.0);
+  this->ImageSlice->VisibilityOn();
+  this->PointCloudActor->VisibilityOff();
+
+  // Make the marker a couple of pixels across.
+  this->MarkerSource->SetRadius(2.0 * this->Image->GetSpacing()[0]);
+
+  this->PixelSelectionStyle->Image = this->ImageData;
+  this->PixelSelectionStyle->SelectedPixel[0] = -1;
+  this->PixelSelectionStyle->SelectedPixel[1] = -1;
+  this->PixelSelectionStyle->SetCurrentRenderer(this->Renderer);
+  this->qvtkWidget->GetRenderWindow()->GetInteractor()->SetInteractorStyle(this->PixelSelectionStyle);
+
+  // The pixels are the descriptors, so there are no arrays to choose from.
+  this->cmbArrayName->clear();
+
+  this->Renderer->ResetCamera();
+  Refresh();
 }
 
 void CompareDescriptorsWidget::PopulateArrayNames(vtkPolyData* const polyData)
@@ -204,6 +309,35 @@ void CompareDescriptorsWidget::PopulateArrayNames(vtkPolyData* const polyData)
     }
 }
 
+void CompareDescriptorsWidget::PopulateArrayNamesFromServer()
+{
+  this->cmbArrayName->clear();
+
+  QueryProtocol::Request request;
+  request.Type = QueryProtocol::ARRAY_NAMES;
+  request.FileName = this->PointCloudFileName;
+
+  // This is the first request for the file, so the server may still be reading it when this times out.
+  QueryProtocol::Response response;
+  if(!ReconnectToServer() || !this->Client.SendRequest(request, response))
+    {
+    std::cerr << "The server did not list the arrays. It may still be loading "
+              << this->PointCloudFileName << ", open the file again to retry." << std::endl;
+    return;
+    }
+
+  if(response.Status != QueryProtocol::SUCCESS)
+    {
+    std::cerr << "The server could not list the arrays: " << response.ErrorMessage << std::endl;
+    return;
+    }
+
+  for(unsigned int i = 0; i < response.ArrayNames.size(); ++i)
+    {
+    this->cmbArrayName->addItem(response.ArrayNames[i].c_str());
+    }
+}
+
 void CompareDescriptorsWidget::on_btnCompute_clicked()
 {
   ComputeDifferences();
@@ -211,6 +345,12 @@ void CompareDescriptorsWidget::on_btnCompute_clicked()
 
 void CompareDescriptorsWidget::ComputeDifferences()
 {
+  if(this->Mode == IMAGE)
+    {
+    ComputeImageDifferences();
+    return;
+    }
+
   vtkIdType numberOfPoints = this->PointCloud->GetNumberOfPoints();
   std::cout << "There are " << numberOfPoints << " points." << std::endl;
 
@@ -228,29 +368,30 @@ void CompareDescriptorsWidget::ComputeDifferences()
   
   std::string nameOfArrayToCompare = this->cmbArrayName->currentText().toStdString();
   std::cout << "nameOfArrayToCompare: " << nameOfArrayToCompare << std::endl;
-  vtkDataArray* descriptorArray = this->PointCloud->GetPointData()->GetArray(nameOfArrayToCompare.c_str());
+  vtkSmartPointer<vtkFloatArray> differences = vtkSmartPointer<vtkFloatArray>::New();
+  differences->SetName("DescriptorDifferences");
 
-  if(!descriptorArray)
+  // In server mode the descriptor arrays were not loaded, so only the server can look them up.
+  if(this->UseServer)
     {
-    std::string errorString = "Array " + nameOfArrayToCompare + " not found!";
-    throw std::runtime_error(errorString); // The array should always be found because we are selecting it from a list of available arrays!
+    if(!ComputeDifferencesOnServer(nameOfArrayToCompare, selectedPointId, differences))
+      {
+      return;
+      }
     }
+  else
+    {
+    vtkDataArray* descriptorArray = this->PointCloud->GetPointData()->GetArray(nameOfArrayToCompare.c_str());
 
-  double* selectedDescriptor = new double[descriptorArray->GetNumberOfComponents()];
-  descriptorArray->GetTuple(selectedPointId, selectedDescriptor);
-  std::cout << "selectedDescriptor: " << selectedDescriptor[0] << " " << selectedDescriptor[1] << std::endl;
-
-  vtkSmartPointer<vtkFloatArray> differences = vtkSmartPointer<vtkFloatArray>::New();
-  differences->SetName("DescriptorDifferences");
-  differences->SetNumberOfComponents(1);
-  differences->SetNumberOfTuples(numberOfPoints);
+    if(!descriptorArray)
+      {
+      std::string errorString = "Array " + nameOfArrayToCompare + " not found!";
+      throw std::runtime_error(errorString); // The array should always be found because we are selecting it from a list of available arrays!
+      }
 
-  for(vtkIdType pointId = 0; pointId < this->PointCloud->GetNumberOfPoints(); ++pointId)
-    {
-    double* currentDescriptor = descriptorArray->GetTuple(pointId);
-    //std::cout << "descriptor " << pointId << " : " << currentDescriptor[0] << " " << currentDescriptor[1] << std::endl;
-    float difference = Helpers::ArrayDifference(selectedDescriptor, currentDescriptor, descriptorArray->GetNumberOfComponents());
-    differences->SetValue(pointId, difference);
+    std::vector<double> selectedDescriptor(descriptorArray->GetNumberOfComponents());
+    descriptorArray->GetTuple(selectedPointId, &selectedDescriptor[0]);
+    Helpers::ComputeDescriptorDifferences(descriptorArray, &selectedDescriptor[0], differences);
     }
 
   this->PointCloud->GetPointData()->AddArray(differences);
@@ -258,21 +399,117 @@ void CompareDescriptorsWidget::ComputeDifferences()
 
   float range[2];
   differences->GetValueRange(range);
+  std::cout << "Range: " << range[0] << ", " << range[1] << std::endl;
+  vtkSmartPointer<vtkLookupTable> lookupTable = vtkSmartPointer<vtkLookupTable>::New();
+  Helpers::ColorByDifferences(this->PointCloudMapper, lookupTable, range);
+
+  this->qvtkWidget->GetRenderWindow()->Render();
+  //PopulateArrayNames(this->PointCloud);
+}
+
+void CompareDescriptorsWidget::ComputeImageDifferences()
+{
+  FloatVectorImageType::IndexType selectedPixel;
+  selectedPixel[0] = this->PixelSelectionStyle->SelectedPixel[0];
+  selectedPixel[1] = this->PixelSelectionStyle->SelectedPixel[1];
+  std::cout << "selectedPixel: " << selectedPixel << std::endl;
+
+  if(!this->Image->GetLargestPossibleRegion().IsInside(selectedPixel))
+    {
+    std::cerr << "You must select a pixel to compare!" << std::endl;
+    return;
+    }
+
+  // The filter splits the image into regions that are compared on separate threads.
+  typedef DescriptorDistanceImageFilter<FloatVectorImageType, FloatScalarImageType> DistanceFilterType;
+  DistanceFilterType::Pointer distanceFilter = DistanceFilterType::New();
+  distanceFilter->SetInput(this->Image);
+  distanceFilter->SetQueryDescriptor(this->Image->GetPixel(selectedPixel));
+  try
+    {
+    distanceFilter->Update();
+    }
+  catch(itk::ExceptionObject& exception)
+    {
+    std::cerr << "Could not compute the difference image: " << exception << std::endl;
+    return;
+    }
+
+  ITKVTKHelpers::ITKScalarImageToVTKImage(distanceFilter->GetOutput(), this->ImageData);
+
+  double range[2];
+  this->ImageData->GetScalarRange(range);
   vtkSmartPointer<vtkLookupTable> lookupTable = vtkSmartPointer<vtkLookupTable>::New();
   std::cout << "Range: " << range[0] << ", " << range[1] << std::endl;
   lookupTable->SetTableRange(range[0], range[1]);
   lookupTable->SetHueRange(0, 1);
 
-  this->PointCloudMapper->SetLookupTable(lookupTable);
-  //std::cout << "UseLookupTableScalarRange " << this->Pane->PointCloudMapper->GetUseLookupTableScalarRange() << std::endl;
-  //this->Pane->PointCloudMapper->SetUseLookupTableScalarRange(false);
+  this->ImageSlice->GetProperty()->SetLookupTable(lookupTable);
+  this->ImageSlice->GetProperty()->UseLookupTableScalarRangeOn();
 
-  // Without this, only a small band of colors is produce around the point.
-  // I'm not sure why the scalar range of the data set is not the same?
-  this->PointCloudMapper->SetUseLookupTableScalarRange(true);
+  Refresh();
+}
 
-  this->qvtkWidget->GetRenderWindow()->Render();
-  //PopulateArrayNames(this->PointCloud);
+bool CompareDescriptorsWidget::ConnectToServer(const std::string& serverName)
+{
+  if(!this->Client.Connect(serverName))
+    {
+    return false;
+    }
+
+  this->Client.SetTimeout(ServerTimeout);
+  this->ServerName = serverName;
+  this->UseServer = true;
+  return true;
+}
+
+bool CompareDescriptorsWidget::ReconnectToServer()
+{
+  if(this->Client.IsConnected())
+    {
+    return true;
+    }
+
+  std::cerr << "Lost the connection to " << this->ServerName << ", reconnecting." << std::endl;
+  return this->Client.Connect(this->ServerName);
+}
+
+bool CompareDescriptorsWidget::ComputeDifferencesOnServer(const std::string& nameOfArrayToCompare,
+                                                          const vtkIdType selectedPointId,
+                                                          vtkFloatArray* const differences)
+{
+  QueryProtocol::Request request;
+  request.Type = QueryProtocol::COMPARE;
+  request.FileName = this->PointCloudFileName;
+  request.ArrayName = nameOfArrayToCompare;
+  request.QueryId = selectedPointId;
+
+  QueryProtocol::Response response;
+  if(!ReconnectToServer() || !this->Client.SendRequest(request, response))
+    {
+    std::cerr << "The server did not answer. Click Compare to try again." << std::endl;
+    return false;
+    }
+
+  if(response.Status != QueryProtocol::SUCCESS)
+    {
+    std::cerr << "The server could not compute the differences: " << response.ErrorMessage << std::endl;
+    return false;
+    }
+
+  // The server caches clouds by path, so it may hold a different version of the file than the one shown here.
+  if(static_cast<vtkIdType>(response.Differences.size()) != this->PointCloud->GetNumberOfPoints())
+    {
+    std::cerr << "The server returned " << response.Differences.size() << " differences but the point cloud has "
+              << this->PointCloud->GetNumberOfPoints() << " points. Is the server using a different version of "
+              << this->PointCloudFileName << "?" << std::endl;
+    return false;
+    }
+
+  differences->SetNumberOfComponents(1);
+  differences->SetNumberOfTuples(response.Differences.size());
+  std::copy(response.Differences.begin(), response.Differences.end(), differences->GetPointer(0));
+  return true;
 }
 
 void CompareDescriptorsWidget::on_actionOpenPointCloud_activated()
@@ -289,3 +526,18 @@ void CompareDescriptorsWidget::on_actionOpenPointCloud_activated()
 
   LoadPointCloud(fileName.toStdString());
 }
+
+void CompareDescriptorsWidget::on_actionOpenImage_activated()
+{
+  // Get a filename to open
+  QString fileName = QFileDialog::getOpenFileName(this, "Open File", ".", "Images (*.mha *.mhd *.nrrd *.tif *.png)");
+
+  std::cout << "Got filename: " << fileName.toStdString() << std::endl;
+  if(fileName.toStdString().empty())
+    {
+    std::cout << "Filename was empty." << std::endl;
+    return;
+    }
+
+  LoadImage(fileName.toStdString());
+}
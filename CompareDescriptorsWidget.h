@@ -34,14 +34,19 @@
 class QProgressDialog;
 
 // Custom
+#include "PixelSelectionStyle2D.h"
 #include "PointSelectionStyle3D.h"
+#include "QueryClient.h"
 #include "Types.h"
 
 // Forward declarations
 class vtkActor;
 class vtkBorderWidget;
+class vtkFloatArray;
 class vtkImageData;
 class vtkImageActor;
+class vtkImageSlice;
+class vtkImageSliceMapper;
 class vtkPointPicker;
 class vtkPolyData;
 class vtkPolyDataMapper;
@@ -59,10 +64,17 @@ public:
 
   void LoadPointCloud(const std::string& fileName);
 
+  /** Load an image with a descriptor per pixel. Comparisons then produce a difference image instead of coloring a point cloud. */
+  void LoadImage(const std::string& fileName);
+
   void ComputeDifferences();
 
+  /** Request the differences from a running CompareDescriptorsServer instead of computing them here. */
+  bool ConnectToServer(const std::string& serverName);
+
 public slots:
   void on_actionOpenPointCloud_activated();
+  void on_actionOpenImage_activated();
   void on_btnCompute_clicked();
 
   void on_actionHelp_activated();
@@ -72,7 +84,43 @@ private:
 
   void PopulateArrayNames(vtkPolyData* const polyData);
 
+  /** Get the array names from the server, because in server mode the arrays are not loaded here. */
+  void PopulateArrayNamesFromServer();
+
+  /** Whether the widget is comparing the points of a point cloud or the pixels of an image. */
+  enum ModeEnum {POINT_CLOUD, IMAGE};
+  ModeEnum Mode;
+
+  void ComputeImageDifferences();
+
+  FloatVectorImageType::Pointer Image;
+
+  vtkSmartPointer<vtkImageData> ImageData;
+  vtkSmartPointer<vtkImageSliceMapper> ImageSliceMapper;
+  vtkSmartPointer<vtkImageSlice> ImageSlice;
+
+  vtkSmartPointer<PixelSelectionStyle2D> PixelSelectionStyle;
+
+  void SelectedPixelCallback(vtkObject* caller, long unsigned int eventId, void* callData);
+
   vtkSmartPointer<vtkPolyData> PointCloud;
+  std::string PointCloudFileName;
+
+  QueryClient Client;
+
+  /** Set once ConnectToServer() succeeds. From then on point clouds are loaded without their descriptor
+    * arrays, so they can only be compared on the server, even if the connection is later lost. */
+  bool UseServer;
+  std::string ServerName;
+
+  /** The server only answers within this time, so a busy or hung server can not freeze the GUI. */
+  static const int ServerTimeout = 30000;
+
+  /** Reconnect if the connection to the server was lost. Returns false if the server can not be reached. */
+  bool ReconnectToServer();
+
+  bool ComputeDifferencesOnServer(const std::string& nameOfArrayToCompare, const vtkIdType selectedPointId,
+                                  vtkFloatArray* const differences);
 
   void SharedConstructor();
   QFutureWatcher<void> FutureWatcher;
@@ -0,0 +1,63 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef DescriptorDistanceImageFilter_H
+#define DescriptorDistanceImageFilter_H
+
+// ITK
+#include "itkImageToImageFilter.h"
+
+/** Compute the difference between the descriptor of every pixel of a vector image and a query descriptor.
+  * The output region is split across threads by ITK, and only the requested region of the input is used,
+  * so the filter can be streamed (e.g. by an ImageFileWriter with several stream divisions) over images
+  * that do not fit in memory. */
+template <typename TInputImage, typename TOutputImage>
+class DescriptorDistanceImageFilter : public itk::ImageToImageFilter<TInputImage, TOutputImage>
+{
+public:
+  typedef DescriptorDistanceImageFilter Self;
+  typedef itk::ImageToImageFilter<TInputImage, TOutputImage> Superclass;
+  typedef itk::SmartPointer<Self> Pointer;
+  typedef itk::SmartPointer<const Self> ConstPointer;
+
+  itkNewMacro(Self);
+
+  itkTypeMacro(DescriptorDistanceImageFilter, ImageToImageFilter);
+
+  typedef typename TInputImage::PixelType DescriptorType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+
+  void SetQueryDescriptor(const DescriptorType& queryDescriptor);
+
+protected:
+  DescriptorDistanceImageFilter() {}
+
+  void BeforeThreadedGenerateData();
+
+  void ThreadedGenerateData(const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType threadId);
+
+private:
+  DescriptorDistanceImageFilter(const Self&); // Purposely not implemented.
+  void operator=(const Self&); // Purposely not implemented.
+
+  DescriptorType QueryDescriptor;
+};
+
+#include "DescriptorDistanceImageFilter.hxx"
+
+#endif
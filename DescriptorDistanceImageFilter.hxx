@@ -0,0 +1,65 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+// ITK
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+
+// Custom
+#include "Helpers.h"
+
+template <typename TInputImage, typename TOutputImage>
+void DescriptorDistanceImageFilter<TInputImage, TOutputImage>::SetQueryDescriptor(const DescriptorType& queryDescriptor)
+{
+  this->QueryDescriptor = queryDescriptor;
+  this->Modified();
+}
+
+template <typename TInputImage, typename TOutputImage>
+void DescriptorDistanceImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
+{
+  if(this->QueryDescriptor.GetSize() != this->GetInput()->GetNumberOfComponentsPerPixel())
+    {
+    itkExceptionMacro(<< "The query descriptor has " << this->QueryDescriptor.GetSize()
+                      << " components but the image has " << this->GetInput()->GetNumberOfComponentsPerPixel());
+    }
+}
+
+template <typename TInputImage, typename TOutputImage>
+void DescriptorDistanceImageFilter<TInputImage, TOutputImage>::ThreadedGenerateData(
+  const OutputImageRegionType& outputRegionForThread, itk::ThreadIdType)
+{
+  itk::ImageRegionConstIterator<TInputImage> inputIterator(this->GetInput(), outputRegionForThread);
+  itk::ImageRegionIterator<TOutputImage> outputIterator(this->GetOutput(), outputRegionForThread);
+
+  unsigned int numberOfComponents = this->QueryDescriptor.GetSize();
+
+  while(!inputIterator.IsAtEnd())
+    {
+    // For a VectorImage this refers to the pixel's components in the image buffer rather than copying them.
+    DescriptorType descriptor = inputIterator.Get();
+
+    // Use the same kernel as the point cloud comparison.
+    float difference = Helpers::ArrayDifference(this->QueryDescriptor.GetDataPointer(), descriptor.GetDataPointer(),
+                                                numberOfComponents);
+    outputIterator.Set(static_cast<typename TOutputImage::PixelType>(difference));
+
+    ++inputIterator;
+    ++outputIterator;
+    }
+}
@@ -18,13 +18,20 @@
 
 #include "Helpers.h"
 
+// STL
+#include <algorithm>
+#include <queue>
+
 // VTK
+#include <vtkFloatArray.h>
 #include <vtkIdList.h>
 #include <vtkKdTree.h>
+#include <vtkLookupTable.h>
 #include <vtkMath.h>
 #include <vtkPoints.h>
 #include <vtkPointData.h>
 #include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
 #include <vtkProp.h>
 #include <vtkRenderer.h>
 #include <vtkSmartPointer.h>
@@ -91,4 +98,123 @@ float ComputeAverageSpacing(vtkPoints* points, unsigned int numberOfPointsToUse)
   return averageDistance;
 }
 
+void ComputeDescriptorDifferences(vtkDataArray* const descriptors, const double* const queryDescriptor,
+                                  vtkFloatArray* const differences)
+{
+  vtkIdType numberOfPoints = descriptors->GetNumberOfTuples();
+  unsigned int numberOfComponents = descriptors->GetNumberOfComponents();
+
+  differences->SetNumberOfComponents(1);
+  differences->SetNumberOfTuples(numberOfPoints);
+
+  // Use the GetTuple overload that copies into our own buffer. The overload returning a pointer
+  // writes to a buffer owned by the array, which is not safe when the array is shared between threads.
+  std::vector<double> currentDescriptor(numberOfComponents);
+  for(vtkIdType pointId = 0; pointId < numberOfPoints; ++pointId)
+    {
+    descriptors->GetTuple(pointId, &currentDescriptor[0]);
+    float difference = ArrayDifference<const double>(queryDescriptor, &currentDescriptor[0], numberOfComponents);
+    differences->SetValue(pointId, difference);
+    }
+}
+
+std::vector<DescriptorMatch> FindNearestDescriptors(vtkFloatArray* const differences, const unsigned int k)
+{
+  // Keep only the best 'k' seen so far in a max-heap, so the memory used does not grow with the number of points.
+  std::priority_queue<DescriptorMatch> nearest;
+  if(k > 0)
+    {
+    for(vtkIdType pointId = 0; pointId < differences->GetNumberOfTuples(); ++pointId)
+      {
+      float difference = differences->GetValue(pointId);
+      if(nearest.size() < k)
+        {
+        nearest.push(DescriptorMatch(pointId, difference));
+        }
+      else if(difference < nearest.top().Difference)
+        {
+        nearest.pop();
+        nearest.push(DescriptorMatch(pointId, difference));
+        }
+      }
+    }
+
+  // The heap pops the largest difference first, so fill the result from the back.
+  std::vector<DescriptorMatch> matches(nearest.size());
+  for(unsigned int i = matches.size(); i > 0; --i)
+    {
+    matches[i - 1] = nearest.top();
+    nearest.pop();
+    }
+  return matches;
+}
+
+std::vector<DescriptorMatch> FindDescriptorsWithinRadius(vtkFloatArray* const differences, const float radius)
+{
+  std::vector<DescriptorMatch> matches;
+  for(vtkIdType pointId = 0; pointId < differences->GetNumberOfTuples(); ++pointId)
+    {
+    if(differences->GetValue(pointId) <= radius)
+      {
+      matches.push_back(DescriptorMatch(pointId, differences->GetValue(pointId)));
+      }
+    }
+
+  std::sort(matches.begin(), matches.end());
+  return matches;
+}
+
+void ColorByDifferences(vtkPolyDataMapper* const mapper, vtkLookupTable* const lookupTable, const float range[2])
+{
+  lookupTable->SetTableRange(range[0], range[1]);
+  lookupTable->SetHueRange(0, 1);
+
+  mapper->SetLookupTable(lookupTable);
+
+  // Without this, only a small band of colors is produce around the point.
+  // I'm not sure why the scalar range of the data set is not the same?
+  mapper->SetUseLookupTableScalarRange(true);
+}
+
+DifferenceStatistics ComputeDifferenceStatistics(vtkFloatArray* const differences)
+{
+  DifferenceStatistics statistics;
+  statistics.Count = differences->GetNumberOfTuples();
+  if(statistics.Count == 0)
+    {
+    return statistics;
+    }
+
+  statistics.Minimum = differences->GetValue(0);
+  statistics.Maximum = differences->GetValue(0);
+  for(vtkIdType pointId = 0; pointId < statistics.Count; ++pointId)
+    {
+    float difference = differences->GetValue(pointId);
+    statistics.Minimum = std::min(statistics.Minimum, difference);
+    statistics.Maximum = std::max(statistics.Maximum, difference);
+    statistics.Sum += difference;
+    }
+  return statistics;
+}
+
+DifferenceStatistics MergeDifferenceStatistics(const DifferenceStatistics& statistics1, const DifferenceStatistics& statistics2)
+{
+  // The minimum and maximum of an empty set are meaningless, so don't let them into the result.
+  if(statistics1.Count == 0)
+    {
+    return statistics2;
+    }
+  if(statistics2.Count == 0)
+    {
+    return statistics1;
+    }
+
+  DifferenceStatistics merged;
+  merged.Minimum = std::min(statistics1.Minimum, statistics2.Minimum);
+  merged.Maximum = std::max(statistics1.Maximum, statistics2.Maximum);
+  merged.Sum = statistics1.Sum + statistics2.Sum;
+  merged.Count = statistics1.Count + statistics2.Count;
+  return merged;
+}
+
 } // end namespace
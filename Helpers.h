@@ -19,9 +19,38 @@
 #ifndef HELPERS_H
 #define HELPERS_H
 
+// STL
+#include <vector>
+
 // VTK
+#include <vtkType.h>
+class vtkDataArray;
+class vtkFloatArray;
+class vtkLookupTable;
 class vtkPolyData;
 class vtkPoints;
+class vtkPolyDataMapper;
+
+/** A point and how far its descriptor is from the query descriptor. */
+struct DescriptorMatch
+{
+  vtkIdType Id;
+  float Difference;
+  DescriptorMatch() : Id(-1), Difference(0) {}
+  DescriptorMatch(const vtkIdType id, const float difference) : Id(id), Difference(difference) {}
+  bool operator<(const DescriptorMatch& other) const { return this->Difference < other.Difference; }
+};
+
+/** Summary of a set of differences. Statistics of disjoint sets can be merged, so each shard of
+  * a point cloud can compute its own and a coordinator can combine them. */
+struct DifferenceStatistics
+{
+  float Minimum;
+  float Maximum;
+  double Sum;
+  vtkIdType Count;
+  DifferenceStatistics() : Minimum(0), Maximum(0), Sum(0), Count(0) {}
+};
 
 namespace Helpers
 {
@@ -32,6 +61,25 @@ float ComputeAverageSpacing(vtkPoints* const points, const unsigned int numberOf
 template <typename T>
 float ArrayDifference(T* const array1, T* const array2, const unsigned int length);
 
+/** Compare 'queryDescriptor' to every tuple of 'descriptors' and store the differences in 'differences'.
+  * Only reads from 'descriptors', so several calls may share the same array from different threads. */
+void ComputeDescriptorDifferences(vtkDataArray* const descriptors, const double* const queryDescriptor,
+                                  vtkFloatArray* const differences);
+
+/** Get the 'k' points with the smallest differences, sorted by increasing difference. Uses O(k) memory beyond 'differences'. */
+std::vector<DescriptorMatch> FindNearestDescriptors(vtkFloatArray* const differences, const unsigned int k);
+
+/** Get all points whose difference is at most 'radius', sorted by increasing difference. */
+std::vector<DescriptorMatch> FindDescriptorsWithinRadius(vtkFloatArray* const differences, const float radius);
+
+/** Color 'mapper' by its active scalars (the differences) through 'lookupTable', over 'range'.
+  * Used by both the widget and the batch renderer so they color results the same way. */
+void ColorByDifferences(vtkPolyDataMapper* const mapper, vtkLookupTable* const lookupTable, const float range[2]);
+
+DifferenceStatistics ComputeDifferenceStatistics(vtkFloatArray* const differences);
+
+DifferenceStatistics MergeDifferenceStatistics(const DifferenceStatistics& statistics1, const DifferenceStatistics& statistics2);
+
 }
 
 #include "Helpers.hxx"
@@ -0,0 +1,81 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "ITKVTKHelpers.h"
+
+// ITK
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+// VTK
+#include <vtkImageData.h>
+
+namespace ITKVTKHelpers
+{
+
+template <typename TImage>
+static void SetupVTKImage(const TImage* const image, vtkImageData* const outputImage)
+{
+  typename TImage::RegionType region = image->GetLargestPossibleRegion();
+
+  outputImage->SetOrigin(image->GetOrigin()[0], image->GetOrigin()[1], 0);
+  outputImage->SetSpacing(image->GetSpacing()[0], image->GetSpacing()[1], 1);
+  outputImage->SetExtent(region.GetIndex()[0], region.GetIndex()[0] + region.GetSize()[0] - 1,
+                         region.GetIndex()[1], region.GetIndex()[1] + region.GetSize()[1] - 1,
+                         0, 0);
+  outputImage->SetNumberOfScalarComponents(1);
+  outputImage->SetScalarTypeToFloat();
+  outputImage->AllocateScalars();
+}
+
+void ITKScalarImageToVTKImage(const FloatScalarImageType* const image, vtkImageData* const outputImage)
+{
+  SetupVTKImage(image, outputImage);
+
+  itk::ImageRegionConstIteratorWithIndex<FloatScalarImageType> imageIterator(image, image->GetLargestPossibleRegion());
+
+  while(!imageIterator.IsAtEnd())
+    {
+    float* pixel = static_cast<float*>(outputImage->GetScalarPointer(imageIterator.GetIndex()[0],
+                                                                      imageIterator.GetIndex()[1], 0));
+    pixel[0] = imageIterator.Get();
+
+    ++imageIterator;
+    }
+
+  outputImage->Modified();
+}
+
+void ITKVectorImageMagnitudeToVTKImage(const FloatVectorImageType* const image, vtkImageData* const outputImage)
+{
+  SetupVTKImage(image, outputImage);
+
+  itk::ImageRegionConstIteratorWithIndex<FloatVectorImageType> imageIterator(image, image->GetLargestPossibleRegion());
+
+  while(!imageIterator.IsAtEnd())
+    {
+    float* pixel = static_cast<float*>(outputImage->GetScalarPointer(imageIterator.GetIndex()[0],
+                                                                      imageIterator.GetIndex()[1], 0));
+    pixel[0] = imageIterator.Get().GetNorm();
+
+    ++imageIterator;
+    }
+
+  outputImage->Modified();
+}
+
+} // end namespace
@@ -0,0 +1,39 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef ITKVTKHELPERS_H
+#define ITKVTKHELPERS_H
+
+// VTK
+class vtkImageData;
+
+// Custom
+#include "Types.h"
+
+namespace ITKVTKHelpers
+{
+
+/** Copy a scalar image into a single component float vtkImageData. */
+void ITKScalarImageToVTKImage(const FloatScalarImageType* const image, vtkImageData* const outputImage);
+
+/** Store the magnitude of each pixel of a vector image in a single component float vtkImageData, for display. */
+void ITKVectorImageMagnitudeToVTKImage(const FloatVectorImageType* const image, vtkImageData* const outputImage);
+
+}
+
+#endif
@@ -0,0 +1,90 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "LocalProcessShardTransport.h"
+
+// STL
+#include <iostream>
+#include <sstream>
+
+// Qt
+#include <QCoreApplication>
+#include <QProcess>
+#include <QStringList>
+
+// Each worker needs its own socket name, even when several coordinators run at once.
+static std::string CreateServerName()
+{
+  static unsigned int numberOfServers = 0;
+  std::stringstream ss;
+  ss << "CompareDescriptorsShard-" << QCoreApplication::applicationPid() << "-" << numberOfServers++;
+  return ss.str();
+}
+
+LocalProcessShardTransport::LocalProcessShardTransport(const std::string& serverExecutable,
+                                                       const std::string& shardFileName) :
+  LocalSocketShardTransport(CreateServerName(), shardFileName), ServerExecutable(serverExecutable)
+{
+  this->Process = new QProcess;
+}
+
+LocalProcessShardTransport::~LocalProcessShardTransport()
+{
+  if(this->Process->state() != QProcess::NotRunning)
+    {
+    this->Process->terminate();
+    if(!this->Process->waitForFinished())
+      {
+      this->Process->kill();
+      this->Process->waitForFinished();
+      }
+    }
+  delete this->Process;
+}
+
+bool LocalProcessShardTransport::Start()
+{
+  QStringList arguments;
+  arguments << this->ServerName.c_str() << this->ShardFileName.c_str();
+  this->Process->start(this->ServerExecutable.c_str(), arguments);
+  if(!this->Process->waitForStarted())
+    {
+    std::cerr << "Could not start " << this->ServerExecutable << std::endl;
+    return false;
+    }
+
+  // The server loads the shard before it starts listening, and says so once it is listening.
+  // Loading a large shard can take a long time, so wait for as long as the process is alive.
+  while(true)
+    {
+    while(this->Process->canReadLine())
+      {
+      std::string line = QString(this->Process->readLine()).trimmed().toStdString();
+      if(line.find("Listening on") == 0)
+        {
+        return Connect();
+        }
+      }
+
+    if(!this->Process->waitForReadyRead(-1))
+      {
+      std::cerr << "The worker for " << this->ShardFileName << " exited before it was ready." << std::endl;
+      return false;
+      }
+    }
+}
@@ -0,0 +1,50 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef LocalProcessShardTransport_H
+#define LocalProcessShardTransport_H
+
+// Superclass
+#include "LocalSocketShardTransport.h"
+
+// Qt
+class QProcess;
+
+/** Start a CompareDescriptorsServer process on this machine that holds a single shard, and reach it
+  * through a local socket. This runs the sharded comparison on one box, e.g. for testing. */
+class LocalProcessShardTransport : public LocalSocketShardTransport
+{
+public:
+  LocalProcessShardTransport(const std::string& serverExecutable, const std::string& shardFileName);
+
+  /** Stops the worker process. */
+  ~LocalProcessShardTransport();
+
+  /** Start the worker, wait until it has loaded the shard, and connect to it. */
+  bool Start();
+
+private:
+  LocalProcessShardTransport(const LocalProcessShardTransport&); // Purposely not implemented.
+  void operator=(const LocalProcessShardTransport&); // Purposely not implemented.
+
+  std::string ServerExecutable;
+
+  QProcess* Process;
+};
+
+#endif
@@ -0,0 +1,45 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "LocalSocketShardTransport.h"
+
+LocalSocketShardTransport::LocalSocketShardTransport(const std::string& serverName, const std::string& shardFileName) :
+  ServerName(serverName), ShardFileName(shardFileName)
+{
+
+}
+
+bool LocalSocketShardTransport::Connect()
+{
+  return this->Client.Connect(this->ServerName);
+}
+
+bool LocalSocketShardTransport::Send(const QueryProtocol::Request& request, unsigned int& requestId)
+{
+  return this->Client.Send(request, requestId);
+}
+
+bool LocalSocketShardTransport::Receive(const unsigned int requestId, QueryProtocol::Response& response)
+{
+  return this->Client.Receive(requestId, response);
+}
+
+std::string LocalSocketShardTransport::GetShardFileName() const
+{
+  return this->ShardFileName;
+}
@@ -0,0 +1,50 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef LocalSocketShardTransport_H
+#define LocalSocketShardTransport_H
+
+// Superclass
+#include "ShardTransport.h"
+
+// Custom
+#include "QueryClient.h"
+
+/** Reach a shard through a CompareDescriptorsServer that is already listening on a local socket. */
+class LocalSocketShardTransport : public ShardTransport
+{
+public:
+  LocalSocketShardTransport(const std::string& serverName, const std::string& shardFileName);
+
+  bool Connect();
+
+  bool Send(const QueryProtocol::Request& request, unsigned int& requestId);
+
+  bool Receive(const unsigned int requestId, QueryProtocol::Response& response);
+
+  std::string GetShardFileName() const;
+
+protected:
+  std::string ServerName;
+
+  std::string ShardFileName;
+
+  QueryClient Client;
+};
+
+#endif
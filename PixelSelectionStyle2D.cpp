@@ -0,0 +1,74 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "PixelSelectionStyle2D.h"
+
+// VTK
+#include <vtkCommand.h>
+#include <vtkImageData.h>
+#include <vtkImageSlice.h>
+#include <vtkObjectFactory.h>
+#include <vtkPropPicker.h>
+#include <vtkRenderWindowInteractor.h>
+
+vtkStandardNewMacro(PixelSelectionStyle2D);
+
+PixelSelectionStyle2D::PixelSelectionStyle2D() : Image(NULL), SelectedPixelEvent(vtkCommand::UserEvent + 2)
+{
+  this->SelectedPixel[0] = -1;
+  this->SelectedPixel[1] = -1;
+  this->Picker = vtkSmartPointer<vtkPropPicker>::New();
+  this->Picker->PickFromListOn();
+}
+
+void PixelSelectionStyle2D::SetImageSlice(vtkImageSlice* const imageSlice)
+{
+  this->Picker->InitializePickList();
+  this->Picker->AddPickList(imageSlice);
+}
+
+void PixelSelectionStyle2D::OnLeftButtonDown()
+{
+  // Only select the pixel if control is held
+  if(this->Interactor->GetControlKey() && this->Image)
+    {
+    this->Picker->Pick(this->Interactor->GetEventPosition()[0],
+                       this->Interactor->GetEventPosition()[1],
+                       0,  // always zero.
+                       this->CurrentRenderer);
+
+    double picked[3] = {0,0,0};
+    this->Picker->GetPickPosition(picked);
+
+    // The depth buffer gives a z slightly off the image plane, which ComputeStructuredCoordinates would reject.
+    picked[2] = this->Image->GetOrigin()[2];
+
+    // Round to the nearest pixel. ComputeStructuredCoordinates returns 0 if the point is outside of the image.
+    int ijk[3];
+    double pcoords[3];
+    if(this->Picker->GetViewProp() && this->Image->ComputeStructuredCoordinates(picked, ijk, pcoords))
+      {
+      this->SelectedPixel[0] = ijk[0] + (pcoords[0] > 0.5 ? 1 : 0);
+      this->SelectedPixel[1] = ijk[1] + (pcoords[1] > 0.5 ? 1 : 0);
+      this->InvokeEvent(this->SelectedPixelEvent, NULL);
+      }
+    }
+
+  // Forward events
+  vtkInteractorStyleImage::OnLeftButtonDown();
+}
@@ -0,0 +1,55 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef PixelSelectionStyle2D_H
+#define PixelSelectionStyle2D_H
+
+// Superclass
+#include <vtkInteractorStyleImage.h>
+
+// VTK
+#include <vtkSmartPointer.h>
+class vtkImageData;
+class vtkImageSlice;
+class vtkPropPicker;
+
+// Define interaction style
+class PixelSelectionStyle2D : public vtkInteractorStyleImage
+{
+public:
+  static PixelSelectionStyle2D* New();
+  PixelSelectionStyle2D();
+  vtkTypeMacro(PixelSelectionStyle2D, vtkInteractorStyleImage);
+
+  void OnLeftButtonDown();
+
+  /** Only pick on 'imageSlice', so clicks on props in front of it (e.g. the marker) still select a pixel. */
+  void SetImageSlice(vtkImageSlice* const imageSlice);
+
+  vtkImageData* Image;
+
+  /** The (x,y) index of the selected pixel, or (-1,-1) if no pixel is selected. */
+  int SelectedPixel[2];
+
+  int SelectedPixelEvent;
+
+private:
+  vtkSmartPointer<vtkPropPicker> Picker;
+};
+
+#endif
@@ -0,0 +1,143 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "QueryClient.h"
+
+// STL
+#include <iostream>
+
+// Qt
+#include <QLocalSocket>
+
+QueryClient::QueryClient() : NextRequestId(0), Timeout(-1)
+{
+  this->Socket = new QLocalSocket;
+}
+
+QueryClient::~QueryClient()
+{
+  delete this->Socket;
+}
+
+bool QueryClient::Connect(const std::string& serverName)
+{
+  this->Socket->abort();
+  this->ReceiveBuffer.clear();
+  this->ReceivedResponses.clear();
+  this->AbandonedRequestIds.clear();
+
+  this->Socket->connectToServer(serverName.c_str());
+  if(!this->Socket->waitForConnected())
+    {
+    std::cerr << "Could not connect to " << serverName << ": "
+              << this->Socket->errorString().toStdString() << std::endl;
+    return false;
+    }
+  return true;
+}
+
+bool QueryClient::IsConnected() const
+{
+  return this->Socket->state() == QLocalSocket::ConnectedState;
+}
+
+void QueryClient::SetTimeout(const int milliseconds)
+{
+  this->Timeout = milliseconds;
+}
+
+bool QueryClient::SendRequest(const QueryProtocol::Request& request, QueryProtocol::Response& response)
+{
+  unsigned int requestId;
+  return Send(request, requestId) && Receive(requestId, response);
+}
+
+bool QueryClient::Send(QueryProtocol::Request request, unsigned int& requestId)
+{
+  if(!IsConnected())
+    {
+    return false;
+    }
+
+  request.RequestId = this->NextRequestId++;
+  QueryProtocol::WriteFrame(this->Socket, QueryProtocol::SerializeRequest(request));
+  // A partly written frame would corrupt every later request, so drop the connection if the write does not finish.
+  if(!this->Socket->waitForBytesWritten(this->Timeout))
+    {
+    std::cerr << "Could not send the request to the server: " << this->Socket->errorString().toStdString() << std::endl;
+    this->Socket->abort();
+    return false;
+    }
+
+  requestId = request.RequestId;
+  return true;
+}
+
+bool QueryClient::Receive(const unsigned int requestId, QueryProtocol::Response& response)
+{
+  std::map<unsigned int, QueryProtocol::Response>::iterator iterator = this->ReceivedResponses.find(requestId);
+  while(iterator == this->ReceivedResponses.end())
+    {
+    QByteArray payload;
+    QueryProtocol::FrameStatusEnum frameStatus;
+    while((frameStatus = QueryProtocol::ExtractFrame(this->ReceiveBuffer, QueryProtocol::MaximumResponseSize, payload)) !=
+          QueryProtocol::FRAME_COMPLETE)
+      {
+      if(frameStatus == QueryProtocol::FRAME_TOO_LARGE)
+        {
+        std::cerr << "Received a response that is too large, disconnecting." << std::endl;
+        this->Socket->abort();
+        return false;
+        }
+      if(!this->Socket->waitForReadyRead(this->Timeout))
+        {
+        if(this->Socket->error() == QLocalSocket::SocketTimeoutError)
+          {
+          std::cerr << "The server did not answer within " << this->Timeout << " ms." << std::endl;
+          this->AbandonedRequestIds.insert(requestId);
+          }
+        else
+          {
+          std::cerr << "Lost the connection to the server: " << this->Socket->errorString().toStdString() << std::endl;
+          }
+        return false;
+        }
+      this->ReceiveBuffer.append(this->Socket->readAll());
+      }
+
+    QueryProtocol::Response receivedResponse;
+    if(!QueryProtocol::DeserializeResponse(payload, receivedResponse))
+      {
+      std::cerr << "Received a malformed response." << std::endl;
+      return false;
+      }
+    if(this->AbandonedRequestIds.erase(receivedResponse.RequestId))
+      {
+      continue;
+      }
+    iterator = this->ReceivedResponses.insert(std::make_pair(receivedResponse.RequestId, receivedResponse)).first;
+    if(receivedResponse.RequestId != requestId)
+      {
+      iterator = this->ReceivedResponses.end();
+      }
+    }
+
+  response = iterator->second;
+  this->ReceivedResponses.erase(iterator);
+  return true;
+}
@@ -0,0 +1,78 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef QueryClient_H
+#define QueryClient_H
+
+// STL
+#include <map>
+#include <set>
+#include <string>
+
+// Qt
+#include <QByteArray>
+class QLocalSocket;
+
+// Custom
+#include "QueryProtocol.h"
+
+/** Send requests to a CompareDescriptorsServer and wait for the responses. */
+class QueryClient
+{
+public:
+  QueryClient();
+  ~QueryClient();
+
+  bool Connect(const std::string& serverName);
+
+  bool IsConnected() const;
+
+  /** How long Send() and Receive() wait for the server, in milliseconds. -1 (the default) waits forever. */
+  void SetTimeout(const int milliseconds);
+
+  /** Send 'request' and block until its response arrives. Returns false if the connection failed or the server timed out. */
+  bool SendRequest(const QueryProtocol::Request& request, QueryProtocol::Response& response);
+
+  /** Send 'request' without waiting for the response, so the server can work while the caller does something else.
+    * 'requestId' is set to the id to pass to Receive(). */
+  bool Send(QueryProtocol::Request request, unsigned int& requestId);
+
+  /** Block until the response to request 'requestId' arrives. If this times out, the response is discarded when it arrives later. */
+  bool Receive(const unsigned int requestId, QueryProtocol::Response& response);
+
+private:
+  QueryClient(const QueryClient&); // Purposely not implemented.
+  void operator=(const QueryClient&); // Purposely not implemented.
+
+  QLocalSocket* Socket;
+
+  QByteArray ReceiveBuffer;
+
+  unsigned int NextRequestId;
+
+  int Timeout;
+
+  /** Requests that timed out. Their responses are dropped instead of being kept in ReceivedResponses forever. */
+  std::set<unsigned int> AbandonedRequestIds;
+
+  /** The server computes requests concurrently, so responses can arrive in a different order than
+    * the requests were sent. Responses that arrive before they are asked for are kept here. */
+  std::map<unsigned int, QueryProtocol::Response> ReceivedResponses;
+};
+
+#endif
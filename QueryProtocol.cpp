@@ -0,0 +1,246 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "QueryProtocol.h"
+
+// Qt
+#include <QDataStream>
+#include <QIODevice>
+#include <QString>
+#include <QStringList>
+
+namespace QueryProtocol
+{
+
+static void SetupStream(QDataStream& stream)
+{
+  stream.setVersion(QDataStream::Qt_4_6);
+}
+
+// Large arrays are written as a count followed by a single block in host byte order.
+// This is fine because the server only listens on a local socket.
+template <typename T>
+static void WriteArray(QDataStream& stream, const std::vector<T>& values)
+{
+  stream << static_cast<quint64>(values.size());
+  if(!values.empty())
+    {
+    stream.writeRawData(reinterpret_cast<const char*>(&values[0]), values.size() * sizeof(T));
+    }
+}
+
+template <typename T>
+static bool ReadArray(QDataStream& stream, const int payloadSize, std::vector<T>& values)
+{
+  quint64 numberOfValues;
+  stream >> numberOfValues;
+  // Divide rather than multiply, because a corrupt count times sizeof(T) can wrap around to a small number.
+  if(stream.status() != QDataStream::Ok || numberOfValues > static_cast<quint64>(payloadSize) / sizeof(T))
+    {
+    return false;
+    }
+
+  values.resize(numberOfValues);
+  if(numberOfValues > 0)
+    {
+    int bytesToRead = numberOfValues * sizeof(T);
+    if(stream.readRawData(reinterpret_cast<char*>(&values[0]), bytesToRead) != bytesToRead)
+      {
+      return false;
+      }
+    }
+  return true;
+}
+
+QByteArray SerializeRequest(const Request& request)
+{
+  QByteArray payload;
+  QDataStream stream(&payload, QIODevice::WriteOnly);
+  SetupStream(stream);
+
+  stream << static_cast<quint32>(request.RequestId)
+         << static_cast<quint8>(request.Type)
+         << QString::fromStdString(request.FileName)
+         << QString::fromStdString(request.ArrayName)
+         << static_cast<qint64>(request.QueryId)
+         << static_cast<quint32>(request.K)
+         << request.Radius;
+  WriteArray(stream, request.QueryDescriptor);
+
+  return payload;
+}
+
+bool DeserializeRequest(const QByteArray& payload, Request& request)
+{
+  QDataStream stream(payload);
+  SetupStream(stream);
+
+  quint32 requestId;
+  quint8 type;
+  QString fileName;
+  QString arrayName;
+  qint64 queryId;
+  quint32 k;
+  stream >> requestId >> type >> fileName >> arrayName >> queryId >> k >> request.Radius;
+
+  if(!ReadArray(stream, payload.size(), request.QueryDescriptor) ||
+     stream.status() != QDataStream::Ok || type > ARRAY_NAMES)
+    {
+    return false;
+    }
+
+  request.RequestId = requestId;
+  request.Type = static_cast<RequestTypeEnum>(type);
+  request.FileName = fileName.toStdString();
+  request.ArrayName = arrayName.toStdString();
+  request.QueryId = queryId;
+  request.K = k;
+  return true;
+}
+
+QByteArray SerializeResponse(const Response& response)
+{
+  QByteArray payload;
+  QDataStream stream(&payload, QIODevice::WriteOnly);
+  SetupStream(stream);
+
+  stream << static_cast<quint32>(response.RequestId)
+         << static_cast<quint8>(response.Status)
+         << QString::fromStdString(response.ErrorMessage);
+
+  WriteArray(stream, response.Differences);
+
+  stream << static_cast<quint64>(response.Matches.size());
+  for(unsigned int i = 0; i < response.Matches.size(); ++i)
+    {
+    stream << static_cast<qint64>(response.Matches[i].Id) << response.Matches[i].Difference;
+    }
+
+  WriteArray(stream, response.Descriptor);
+
+  stream << response.Statistics.Minimum << response.Statistics.Maximum
+         << response.Statistics.Sum << static_cast<qint64>(response.Statistics.Count);
+
+  QStringList arrayNames;
+  for(unsigned int i = 0; i < response.ArrayNames.size(); ++i)
+    {
+    arrayNames << QString::fromStdString(response.ArrayNames[i]);
+    }
+  stream << arrayNames;
+
+  return payload;
+}
+
+bool DeserializeResponse(const QByteArray& payload, Response& response)
+{
+  QDataStream stream(payload);
+  SetupStream(stream);
+
+  quint32 requestId;
+  quint8 status;
+  QString errorMessage;
+  stream >> requestId >> status >> errorMessage;
+
+  if(!ReadArray(stream, payload.size(), response.Differences))
+    {
+    return false;
+    }
+
+  quint64 numberOfMatches;
+  stream >> numberOfMatches;
+  const quint64 matchSize = sizeof(qint64) + sizeof(float);
+  if(stream.status() != QDataStream::Ok || numberOfMatches > static_cast<quint64>(payload.size()) / matchSize)
+    {
+    return false;
+    }
+
+  response.Matches.resize(numberOfMatches);
+  for(unsigned int i = 0; i < numberOfMatches; ++i)
+    {
+    qint64 id;
+    stream >> id >> response.Matches[i].Difference;
+    response.Matches[i].Id = id;
+    }
+
+  if(!ReadArray(stream, payload.size(), response.Descriptor))
+    {
+    return false;
+    }
+
+  qint64 count;
+  stream >> response.Statistics.Minimum >> response.Statistics.Maximum >> response.Statistics.Sum >> count;
+  response.Statistics.Count = count;
+
+  QStringList arrayNames;
+  stream >> arrayNames;
+  response.ArrayNames.clear();
+  for(int i = 0; i < arrayNames.size(); ++i)
+    {
+    response.ArrayNames.push_back(arrayNames[i].toStdString());
+    }
+
+  if(stream.status() != QDataStream::Ok)
+    {
+    return false;
+    }
+
+  response.RequestId = requestId;
+  response.Status = static_cast<StatusEnum>(status);
+  response.ErrorMessage = errorMessage.toStdString();
+  return true;
+}
+
+void WriteFrame(QIODevice* const device, const QByteArray& payload)
+{
+  QByteArray header;
+  QDataStream stream(&header, QIODevice::WriteOnly);
+  stream << static_cast<quint32>(payload.size());
+
+  device->write(header);
+  device->write(payload);
+}
+
+FrameStatusEnum ExtractFrame(QByteArray& buffer, const quint32 maximumPayloadSize, QByteArray& payload)
+{
+  const int headerSize = sizeof(quint32);
+  if(buffer.size() < headerSize)
+    {
+    return FRAME_INCOMPLETE;
+    }
+
+  QDataStream stream(buffer);
+  quint32 payloadSize;
+  stream >> payloadSize;
+
+  // Check before waiting for the rest of the frame, so a bad size can not make the reader buffer gigabytes.
+  if(payloadSize > maximumPayloadSize)
+    {
+    return FRAME_TOO_LARGE;
+    }
+
+  if(static_cast<quint32>(buffer.size() - headerSize) < payloadSize)
+    {
+    return FRAME_INCOMPLETE;
+    }
+
+  payload = buffer.mid(headerSize, payloadSize);
+  buffer.remove(0, headerSize + payloadSize);
+  return FRAME_COMPLETE;
+}
+
+} // end namespace
@@ -0,0 +1,122 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef QueryProtocol_H
+#define QueryProtocol_H
+
+// STL
+#include <string>
+#include <vector>
+
+// Qt
+#include <QByteArray>
+class QIODevice;
+
+// Custom
+#include "Helpers.h"
+
+/** The binary messages exchanged between CompareDescriptorsServer and its clients.
+  * Every message is sent as a frame: a quint32 byte count followed by that many bytes
+  * of QDataStream encoded payload. */
+namespace QueryProtocol
+{
+
+/** DESCRIPTOR returns the descriptor of QueryId, STATISTICS summarizes the differences without sending them.
+  * ARRAY_NAMES lists the point data arrays of FileName, so a client does not have to load them to choose one. */
+enum RequestTypeEnum {COMPARE, TOP_K, RADIUS, DESCRIPTOR, STATISTICS, ARRAY_NAMES};
+
+enum StatusEnum {SUCCESS, FAILURE};
+
+struct Request
+{
+  Request() : RequestId(0), Type(COMPARE), QueryId(-1), K(0), Radius(0) {}
+
+  /** Echoed back in the response so a client can match responses to requests. */
+  unsigned int RequestId;
+
+  RequestTypeEnum Type;
+
+  /** The .vtp file to query. It is loaded by the server the first time it is requested. */
+  std::string FileName;
+
+  std::string ArrayName;
+
+  vtkIdType QueryId;
+
+  /** If not empty, compare to this descriptor instead of the descriptor of QueryId.
+    * This lets a query point from one shard be compared against the other shards. */
+  std::vector<double> QueryDescriptor;
+
+  /** Only used by TOP_K requests. */
+  unsigned int K;
+
+  /** Only used by RADIUS requests. */
+  float Radius;
+};
+
+struct Response
+{
+  Response() : RequestId(0), Status(SUCCESS) {}
+
+  unsigned int RequestId;
+
+  StatusEnum Status;
+
+  /** Only set if Status is FAILURE. */
+  std::string ErrorMessage;
+
+  /** The difference of every point, filled by COMPARE requests. */
+  std::vector<float> Differences;
+
+  /** Filled by TOP_K and RADIUS requests, sorted by increasing difference. */
+  std::vector<DescriptorMatch> Matches;
+
+  /** Filled by DESCRIPTOR requests. */
+  std::vector<double> Descriptor;
+
+  /** Filled by STATISTICS requests. */
+  DifferenceStatistics Statistics;
+
+  /** Filled by ARRAY_NAMES requests. */
+  std::vector<std::string> ArrayNames;
+};
+
+QByteArray SerializeRequest(const Request& request);
+bool DeserializeRequest(const QByteArray& payload, Request& request);
+
+QByteArray SerializeResponse(const Response& response);
+bool DeserializeResponse(const QByteArray& payload, Response& response);
+
+/** Prefix 'payload' with its size and write it to 'device'. */
+void WriteFrame(QIODevice* const device, const QByteArray& payload);
+
+/** A request holds a few names and at most one descriptor, so a larger frame can not be a valid request. */
+const quint32 MaximumRequestSize = 64 * 1024 * 1024;
+
+/** A response is read into a single QByteArray, which can not hold more than this. */
+const quint32 MaximumResponseSize = 0x7fffffff - sizeof(quint32);
+
+enum FrameStatusEnum {FRAME_INCOMPLETE, FRAME_COMPLETE, FRAME_TOO_LARGE};
+
+/** If 'buffer' holds a complete frame, move its payload to 'payload', remove the frame from 'buffer' and return FRAME_COMPLETE.
+  * Returns FRAME_TOO_LARGE as soon as the header says the payload is larger than 'maximumPayloadSize'. */
+FrameStatusEnum ExtractFrame(QByteArray& buffer, const quint32 maximumPayloadSize, QByteArray& payload);
+
+} // end namespace
+
+#endif
@@ -0,0 +1,277 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "QueryServer.h"
+
+// STL
+#include <iostream>
+#include <sstream>
+
+// Qt
+#include <QFileInfo>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QMutexLocker>
+#include <QtConcurrentRun>
+
+// VTK
+#include <vtkFloatArray.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkXMLPolyDataReader.h>
+
+// Custom
+#include "Helpers.h"
+
+QueryServer::QueryServer(QObject* parent) : QObject(parent)
+{
+  this->Server = new QLocalServer(this);
+  connect(this->Server, SIGNAL(newConnection()), this, SLOT(NewConnection()));
+}
+
+bool QueryServer::Listen(const std::string& serverName)
+{
+  // Don't take the name over from a server that is still running.
+  QLocalSocket probe;
+  probe.connectToServer(serverName.c_str());
+  if(probe.waitForConnected(1000))
+    {
+    std::cerr << "A server is already listening on " << serverName << std::endl;
+    return false;
+    }
+
+  // Nobody answered, so any socket file with this name was left behind by a server that did not shut down cleanly.
+  QLocalServer::removeServer(serverName.c_str());
+
+  if(!this->Server->listen(serverName.c_str()))
+    {
+    std::cerr << "Could not listen on " << serverName << ": "
+              << this->Server->errorString().toStdString() << std::endl;
+    return false;
+    }
+  return true;
+}
+
+bool QueryServer::LoadPointCloud(const std::string& fileName)
+{
+  return GetPointCloud(fileName) != NULL;
+}
+
+vtkPolyData* QueryServer::GetPointCloud(const std::string& requestedFileName)
+{
+  // Clients may name the same file by different relative paths.
+  std::string fileName = QFileInfo(requestedFileName.c_str()).absoluteFilePath().toStdString();
+
+  // The lock is only held to look at and change the map, so requests for clouds that are already
+  // loaded are not held up while another thread reads a new file.
+  QMutexLocker locker(&this->PointCloudsMutex);
+  while(true)
+    {
+    std::map<std::string, vtkSmartPointer<vtkPolyData> >::iterator iterator = this->PointClouds.find(fileName);
+    if(iterator != this->PointClouds.end())
+      {
+      // Clouds are never removed from the map, so the pointer stays valid after unlocking.
+      return iterator->second;
+      }
+    if(this->LoadingFileNames.find(fileName) == this->LoadingFileNames.end())
+      {
+      break;
+      }
+    this->PointCloudLoaded.wait(&this->PointCloudsMutex);
+    }
+  this->LoadingFileNames.insert(fileName);
+  locker.unlock();
+
+  vtkSmartPointer<vtkPolyData> pointCloud;
+  vtkSmartPointer<vtkXMLPolyDataReader> reader = vtkSmartPointer<vtkXMLPolyDataReader>::New();
+  if(reader->CanReadFile(fileName.c_str()))
+    {
+    reader->SetFileName(fileName.c_str());
+    reader->Update();
+
+    // Shallow copy so the arrays are shared with, rather than duplicated from, the reader's output.
+    pointCloud = vtkSmartPointer<vtkPolyData>::New();
+    pointCloud->ShallowCopy(reader->GetOutput());
+    std::cout << "Loaded " << fileName << " (" << pointCloud->GetNumberOfPoints() << " points)" << std::endl;
+    }
+  else
+    {
+    std::cerr << "Could not read " << fileName << std::endl;
+    }
+
+  locker.relock();
+  this->LoadingFileNames.erase(fileName);
+  if(pointCloud)
+    {
+    this->PointClouds[fileName] = pointCloud;
+    }
+  this->PointCloudLoaded.wakeAll();
+
+  return pointCloud;
+}
+
+QueryProtocol::Response QueryServer::ProcessRequest(const QueryProtocol::Request& request)
+{
+  QueryProtocol::Response response;
+  response.RequestId = request.RequestId;
+  response.Status = QueryProtocol::FAILURE;
+
+  vtkPolyData* pointCloud = GetPointCloud(request.FileName);
+  if(!pointCloud)
+    {
+    response.ErrorMessage = "Could not read " + request.FileName;
+    return response;
+    }
+
+  if(request.Type == QueryProtocol::ARRAY_NAMES)
+    {
+    for(int i = 0; i < pointCloud->GetPointData()->GetNumberOfArrays(); ++i)
+      {
+      response.ArrayNames.push_back(pointCloud->GetPointData()->GetArrayName(i));
+      }
+    response.Status = QueryProtocol::SUCCESS;
+    return response;
+    }
+
+  vtkDataArray* descriptorArray = pointCloud->GetPointData()->GetArray(request.ArrayName.c_str());
+  if(!descriptorArray)
+    {
+    response.ErrorMessage = "Array " + request.ArrayName + " not found!";
+    return response;
+    }
+
+  std::vector<double> queryDescriptor = request.QueryDescriptor;
+  if(queryDescriptor.empty())
+    {
+    if(request.QueryId < 0 || request.QueryId >= descriptorArray->GetNumberOfTuples())
+      {
+      std::stringstream ss;
+      ss << "Query point " << request.QueryId << " is out of range.";
+      response.ErrorMessage = ss.str();
+      return response;
+      }
+
+    queryDescriptor.resize(descriptorArray->GetNumberOfComponents());
+    descriptorArray->GetTuple(request.QueryId, &queryDescriptor[0]);
+    }
+  else if(queryDescriptor.size() != static_cast<unsigned int>(descriptorArray->GetNumberOfComponents()))
+    {
+    response.ErrorMessage = "The query descriptor does not have as many components as " + request.ArrayName;
+    return response;
+    }
+
+  if(request.Type == QueryProtocol::DESCRIPTOR)
+    {
+    response.Descriptor = queryDescriptor;
+    response.Status = QueryProtocol::SUCCESS;
+    return response;
+    }
+
+  // There is no descriptor index: every query scans all of the descriptors. The descriptors are high dimensional
+  // and compared with an L1 difference, where a tree index would still visit most of the points.
+  vtkSmartPointer<vtkFloatArray> differences = vtkSmartPointer<vtkFloatArray>::New();
+  Helpers::ComputeDescriptorDifferences(descriptorArray, &queryDescriptor[0], differences);
+
+  switch(request.Type)
+    {
+    case QueryProtocol::COMPARE:
+      response.Differences.assign(differences->GetPointer(0),
+                                  differences->GetPointer(0) + differences->GetNumberOfTuples());
+      break;
+    case QueryProtocol::TOP_K:
+      response.Matches = Helpers::FindNearestDescriptors(differences, request.K);
+      break;
+    case QueryProtocol::RADIUS:
+      response.Matches = Helpers::FindDescriptorsWithinRadius(differences, request.Radius);
+      break;
+    case QueryProtocol::STATISTICS:
+      response.Statistics = Helpers::ComputeDifferenceStatistics(differences);
+      break;
+    default:
+      break;
+    }
+
+  response.Status = QueryProtocol::SUCCESS;
+  return response;
+}
+
+void QueryServer::NewConnection()
+{
+  while(this->Server->hasPendingConnections())
+    {
+    QLocalSocket* socket = this->Server->nextPendingConnection();
+    connect(socket, SIGNAL(readyRead()), this, SLOT(ReadRequests()));
+    connect(socket, SIGNAL(disconnected()), this, SLOT(ClientDisconnected()));
+    this->ReceiveBuffers[socket] = QByteArray();
+    }
+}
+
+void QueryServer::ReadRequests()
+{
+  QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+  QByteArray& buffer = this->ReceiveBuffers[socket];
+  buffer.append(socket->readAll());
+
+  QByteArray payload;
+  QueryProtocol::FrameStatusEnum frameStatus;
+  while((frameStatus = QueryProtocol::ExtractFrame(buffer, QueryProtocol::MaximumRequestSize, payload)) ==
+        QueryProtocol::FRAME_COMPLETE)
+    {
+    QueryProtocol::Request request;
+    if(!QueryProtocol::DeserializeRequest(payload, request))
+      {
+      std::cerr << "Received a malformed request, disconnecting the client." << std::endl;
+      socket->disconnectFromServer();
+      return;
+      }
+
+    QFutureWatcher<QueryProtocol::Response>* watcher = new QFutureWatcher<QueryProtocol::Response>(this);
+    connect(watcher, SIGNAL(finished()), this, SLOT(RequestFinished()));
+    this->PendingRequests[watcher] = socket;
+    watcher->setFuture(QtConcurrent::run(this, &QueryServer::ProcessRequest, request));
+    }
+
+  if(frameStatus == QueryProtocol::FRAME_TOO_LARGE)
+    {
+    std::cerr << "Received a request that is too large, disconnecting the client." << std::endl;
+    buffer.clear();
+    socket->disconnectFromServer();
+    }
+}
+
+void QueryServer::RequestFinished()
+{
+  QFutureWatcher<QueryProtocol::Response>* watcher =
+    static_cast<QFutureWatcher<QueryProtocol::Response>*>(sender());
+
+  // The client may have disconnected while the request was being computed.
+  QPointer<QLocalSocket> socket = this->PendingRequests.take(watcher);
+  if(socket)
+    {
+    QueryProtocol::WriteFrame(socket, QueryProtocol::SerializeResponse(watcher->result()));
+    }
+
+  watcher->deleteLater();
+}
+
+void QueryServer::ClientDisconnected()
+{
+  QLocalSocket* socket = qobject_cast<QLocalSocket*>(sender());
+  this->ReceiveBuffers.remove(socket);
+  socket->deleteLater();
+}
@@ -0,0 +1,88 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef QueryServer_H
+#define QueryServer_H
+
+// STL
+#include <map>
+#include <set>
+#include <string>
+
+// VTK
+#include <vtkSmartPointer.h>
+class vtkPolyData;
+
+// Qt
+#include <QFutureWatcher>
+#include <QHash>
+#include <QMutex>
+#include <QObject>
+#include <QPointer>
+#include <QWaitCondition>
+class QLocalServer;
+class QLocalSocket;
+
+// Custom
+#include "QueryProtocol.h"
+
+/** Keep point clouds in memory and answer queries about them over a local socket.
+  * Each request is computed on the global QThreadPool so several clients are served at once. */
+class QueryServer : public QObject
+{
+  Q_OBJECT
+public:
+  QueryServer(QObject* parent = 0);
+
+  /** Start accepting clients on the local socket 'serverName'. */
+  bool Listen(const std::string& serverName);
+
+  /** Load a point cloud now rather than on the first request for it. */
+  bool LoadPointCloud(const std::string& fileName);
+
+  /** Compute the answer to a request. This is safe to call from several threads at once. */
+  QueryProtocol::Response ProcessRequest(const QueryProtocol::Request& request);
+
+private slots:
+  void NewConnection();
+  void ReadRequests();
+  void RequestFinished();
+  void ClientDisconnected();
+
+private:
+  vtkPolyData* GetPointCloud(const std::string& fileName);
+
+  QLocalServer* Server;
+
+  /** The loaded point clouds, keyed by file name. */
+  std::map<std::string, vtkSmartPointer<vtkPolyData> > PointClouds;
+  QMutex PointCloudsMutex;
+
+  /** The files that some thread is reading right now. Other threads that want one of them wait on
+    * PointCloudLoaded instead of reading it a second time. Both are guarded by PointCloudsMutex. */
+  std::set<std::string> LoadingFileNames;
+  QWaitCondition PointCloudLoaded;
+
+  /** Bytes received from each client that do not yet form a complete request. */
+  QHash<QLocalSocket*, QByteArray> ReceiveBuffers;
+
+  /** The client waiting for each request that is being computed. */
+  QHash<QFutureWatcher<QueryProtocol::Response>*, QPointer<QLocalSocket> > PendingRequests;
+};
+
+#endif
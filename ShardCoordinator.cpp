@@ -0,0 +1,194 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "ShardCoordinator.h"
+
+// STL
+#include <algorithm>
+#include <iostream>
+
+// Custom
+#include "ShardTransport.h"
+
+ShardCoordinator::~ShardCoordinator()
+{
+  for(unsigned int shardId = 0; shardId < this->Shards.size(); ++shardId)
+    {
+    delete this->Shards[shardId];
+    }
+}
+
+void ShardCoordinator::AddShard(ShardTransport* const shard)
+{
+  this->Shards.push_back(shard);
+}
+
+unsigned int ShardCoordinator::GetNumberOfShards() const
+{
+  return this->Shards.size();
+}
+
+bool ShardCoordinator::Scatter(const QueryProtocol::Request& request, std::vector<QueryProtocol::Response>& responses)
+{
+  // Stop sending at the first failure, but always collect the responses of the shards that were sent
+  // the request, so that no response is left behind in a transport after this returns.
+  std::vector<unsigned int> requestIds;
+  bool success = true;
+  for(unsigned int shardId = 0; shardId < this->Shards.size(); ++shardId)
+    {
+    QueryProtocol::Request shardRequest = request;
+    shardRequest.FileName = this->Shards[shardId]->GetShardFileName();
+    unsigned int requestId;
+    if(!this->Shards[shardId]->Send(shardRequest, requestId))
+      {
+      std::cerr << "Could not send the request to shard " << shardId << std::endl;
+      success = false;
+      break;
+      }
+    requestIds.push_back(requestId);
+    }
+
+  responses.resize(requestIds.size());
+  for(unsigned int shardId = 0; shardId < requestIds.size(); ++shardId)
+    {
+    if(!this->Shards[shardId]->Receive(requestIds[shardId], responses[shardId]))
+      {
+      std::cerr << "Shard " << shardId << " did not answer." << std::endl;
+      success = false;
+      }
+    else if(responses[shardId].Status != QueryProtocol::SUCCESS)
+      {
+      std::cerr << "Shard " << shardId << " failed: " << responses[shardId].ErrorMessage << std::endl;
+      success = false;
+      }
+    }
+
+  return success;
+}
+
+std::vector<ShardMatch> ShardCoordinator::GatherMatches(const std::vector<QueryProtocol::Response>& responses)
+{
+  std::vector<ShardMatch> matches;
+  for(unsigned int shardId = 0; shardId < responses.size(); ++shardId)
+    {
+    for(unsigned int i = 0; i < responses[shardId].Matches.size(); ++i)
+      {
+      matches.push_back(ShardMatch(shardId, responses[shardId].Matches[i]));
+      }
+    }
+
+  std::sort(matches.begin(), matches.end());
+  return matches;
+}
+
+bool ShardCoordinator::GetDescriptor(const std::string& arrayName, const unsigned int shardId, const vtkIdType pointId,
+                                     std::vector<double>& descriptor)
+{
+  if(shardId >= this->Shards.size())
+    {
+    std::cerr << "There is no shard " << shardId << std::endl;
+    return false;
+    }
+
+  QueryProtocol::Request request;
+  request.Type = QueryProtocol::DESCRIPTOR;
+  request.FileName = this->Shards[shardId]->GetShardFileName();
+  request.ArrayName = arrayName;
+  request.QueryId = pointId;
+
+  unsigned int requestId;
+  QueryProtocol::Response response;
+  if(!this->Shards[shardId]->Send(request, requestId) || !this->Shards[shardId]->Receive(requestId, response))
+    {
+    std::cerr << "Shard " << shardId << " did not answer." << std::endl;
+    return false;
+    }
+  if(response.Status != QueryProtocol::SUCCESS)
+    {
+    std::cerr << "Shard " << shardId << " failed: " << response.ErrorMessage << std::endl;
+    return false;
+    }
+
+  descriptor = response.Descriptor;
+  return true;
+}
+
+bool ShardCoordinator::FindNearest(const std::string& arrayName, const std::vector<double>& queryDescriptor,
+                                   const unsigned int k, std::vector<ShardMatch>& matches)
+{
+  // The k nearest points overall are among the k nearest points of each shard.
+  QueryProtocol::Request request;
+  request.Type = QueryProtocol::TOP_K;
+  request.ArrayName = arrayName;
+  request.QueryDescriptor = queryDescriptor;
+  request.K = k;
+
+  std::vector<QueryProtocol::Response> responses;
+  if(!Scatter(request, responses))
+    {
+    return false;
+    }
+
+  matches = GatherMatches(responses);
+  if(matches.size() > k)
+    {
+    matches.resize(k);
+    }
+  return true;
+}
+
+bool ShardCoordinator::FindWithinRadius(const std::string& arrayName, const std::vector<double>& queryDescriptor,
+                                        const float radius, std::vector<ShardMatch>& matches)
+{
+  QueryProtocol::Request request;
+  request.Type = QueryProtocol::RADIUS;
+  request.ArrayName = arrayName;
+  request.QueryDescriptor = queryDescriptor;
+  request.Radius = radius;
+
+  std::vector<QueryProtocol::Response> responses;
+  if(!Scatter(request, responses))
+    {
+    return false;
+    }
+
+  matches = GatherMatches(responses);
+  return true;
+}
+
+bool ShardCoordinator::ComputeStatistics(const std::string& arrayName, const std::vector<double>& queryDescriptor,
+                                         DifferenceStatistics& statistics)
+{
+  QueryProtocol::Request request;
+  request.Type = QueryProtocol::STATISTICS;
+  request.ArrayName = arrayName;
+  request.QueryDescriptor = queryDescriptor;
+
+  std::vector<QueryProtocol::Response> responses;
+  if(!Scatter(request, responses))
+    {
+    return false;
+    }
+
+  statistics = DifferenceStatistics();
+  for(unsigned int shardId = 0; shardId < responses.size(); ++shardId)
+    {
+    statistics = Helpers::MergeDifferenceStatistics(statistics, responses[shardId].Statistics);
+    }
+  return true;
+}
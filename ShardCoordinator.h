@@ -0,0 +1,86 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef ShardCoordinator_H
+#define ShardCoordinator_H
+
+// STL
+#include <string>
+#include <vector>
+
+// Custom
+#include "Helpers.h"
+#include "QueryProtocol.h"
+class ShardTransport;
+
+/** A point of a sharded point cloud and how far its descriptor is from the query descriptor. */
+struct ShardMatch
+{
+  unsigned int ShardId;
+  DescriptorMatch Match;
+  ShardMatch() : ShardId(0) {}
+  ShardMatch(const unsigned int shardId, const DescriptorMatch& match) : ShardId(shardId), Match(match) {}
+  bool operator<(const ShardMatch& other) const { return this->Match < other.Match; }
+};
+
+/** Run queries over a point cloud that is split into shards held by separate workers.
+  * Each query is sent to every shard before any response is waited for, so the shards
+  * compute in parallel. The per-shard answers are then merged into one answer. */
+class ShardCoordinator
+{
+public:
+  ShardCoordinator() {}
+
+  /** Deletes the shards. */
+  ~ShardCoordinator();
+
+  /** Add a shard. The coordinator takes ownership of 'shard'. Shard ids are assigned in the order shards are added. */
+  void AddShard(ShardTransport* const shard);
+
+  unsigned int GetNumberOfShards() const;
+
+  /** Get the descriptor of a point, so it can be used as the query descriptor for the other queries. */
+  bool GetDescriptor(const std::string& arrayName, const unsigned int shardId, const vtkIdType pointId,
+                     std::vector<double>& descriptor);
+
+  /** Get the 'k' points of all shards with the smallest differences, sorted by increasing difference. */
+  bool FindNearest(const std::string& arrayName, const std::vector<double>& queryDescriptor, const unsigned int k,
+                   std::vector<ShardMatch>& matches);
+
+  /** Get the points of all shards whose difference is at most 'radius', sorted by increasing difference. */
+  bool FindWithinRadius(const std::string& arrayName, const std::vector<double>& queryDescriptor, const float radius,
+                        std::vector<ShardMatch>& matches);
+
+  /** Summarize the differences over all shards, e.g. to set the range of a lookup table. */
+  bool ComputeStatistics(const std::string& arrayName, const std::vector<double>& queryDescriptor,
+                         DifferenceStatistics& statistics);
+
+private:
+  ShardCoordinator(const ShardCoordinator&); // Purposely not implemented.
+  void operator=(const ShardCoordinator&); // Purposely not implemented.
+
+  /** Send 'request' to every shard and collect the responses in shard order. */
+  bool Scatter(const QueryProtocol::Request& request, std::vector<QueryProtocol::Response>& responses);
+
+  /** Combine the Matches of every response into one list sorted by increasing difference. */
+  std::vector<ShardMatch> GatherMatches(const std::vector<QueryProtocol::Response>& responses);
+
+  std::vector<ShardTransport*> Shards;
+};
+
+#endif
@@ -0,0 +1,44 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef ShardTransport_H
+#define ShardTransport_H
+
+// STL
+#include <string>
+
+// Custom
+#include "QueryProtocol.h"
+
+/** The connection between a ShardCoordinator and the worker that holds one shard of a point cloud.
+  * Subclasses decide how the worker is reached. Send() must not wait for the response, so the
+  * coordinator can send a request to every shard before waiting on any of them. */
+class ShardTransport
+{
+public:
+  virtual ~ShardTransport() {}
+
+  virtual bool Send(const QueryProtocol::Request& request, unsigned int& requestId) = 0;
+
+  virtual bool Receive(const unsigned int requestId, QueryProtocol::Response& response) = 0;
+
+  /** The file the worker should query for this shard. */
+  virtual std::string GetShardFileName() const = 0;
+};
+
+#endif
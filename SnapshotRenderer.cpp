@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "SnapshotRenderer.h"
+
+// VTK
+#include <vtkActor.h>
+#include <vtkCamera.h>
+#include <vtkFloatArray.h>
+#include <vtkLookupTable.h>
+#include <vtkPNGWriter.h>
+#include <vtkPointData.h>
+#include <vtkPolyData.h>
+#include <vtkPolyDataMapper.h>
+#include <vtkProperty.h>
+#include <vtkRenderer.h>
+#include <vtkRenderWindow.h>
+#include <vtkWindowToImageFilter.h>
+
+// Custom
+#include "Helpers.h"
+
+SnapshotRenderer::SnapshotRenderer(const unsigned int width, const unsigned int height)
+{
+  this->PointCloud = vtkSmartPointer<vtkPolyData>::New();
+
+  this->LookupTable = vtkSmartPointer<vtkLookupTable>::New();
+
+  this->PointCloudMapper = vtkSmartPointer<vtkPolyDataMapper>::New();
+  this->PointCloudMapper->SetInputConnection(this->PointCloud->GetProducerPort());
+
+  this->PointCloudActor = vtkSmartPointer<vtkActor>::New();
+  this->PointCloudActor->SetMapper(this->PointCloudMapper);
+  this->PointCloudActor->GetProperty()->SetRepresentationToPoints();
+
+  this->Renderer = vtkSmartPointer<vtkRenderer>::New();
+  this->Renderer->AddActor(this->PointCloudActor);
+
+  // Without a display this needs VTK to be built with offscreen (e.g. OSMesa) support.
+  this->RenderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+  this->RenderWindow->OffScreenRenderingOn();
+  this->RenderWindow->SetSize(width, height);
+  this->RenderWindow->AddRenderer(this->Renderer);
+
+  this->WindowToImageFilter = vtkSmartPointer<vtkWindowToImageFilter>::New();
+  this->WindowToImageFilter->SetInput(this->RenderWindow);
+  this->WindowToImageFilter->ReadFrontBufferOff();
+  // WriteSnapshot renders the window itself, so don't let the filter render every frame a second time.
+  this->WindowToImageFilter->ShouldRerenderOff();
+
+  this->Writer = vtkSmartPointer<vtkPNGWriter>::New();
+  this->Writer->SetInputConnection(this->WindowToImageFilter->GetOutputPort());
+}
+
+void SnapshotRenderer::SetPointCloud(vtkPolyData* const pointCloud)
+{
+  // Shallow copy so that setting the scalars for a snapshot does not change the caller's point data.
+  this->PointCloud->ShallowCopy(pointCloud);
+}
+
+void SnapshotRenderer::WriteSnapshot(vtkFloatArray* const differences, const SnapshotJob& job, const std::string& fileName)
+{
+  // The values were computed without notifying the array, so mark it as changed for the mapper.
+  differences->Modified();
+  this->PointCloud->GetPointData()->SetScalars(differences);
+
+  float range[2];
+  differences->GetValueRange(range);
+  Helpers::ColorByDifferences(this->PointCloudMapper, this->LookupTable, range);
+
+  vtkCamera* camera = this->Renderer->GetActiveCamera();
+  if(job.HasCamera)
+    {
+    camera->SetPosition(job.Position);
+    camera->SetFocalPoint(job.FocalPoint);
+    camera->SetViewUp(job.ViewUp);
+    this->Renderer->ResetCameraClippingRange();
+    }
+  else
+    {
+    this->Renderer->ResetCamera();
+    }
+
+  this->RenderWindow->Render();
+
+  this->WindowToImageFilter->Modified();
+  this->Writer->SetFileName(fileName.c_str());
+  this->Writer->Write();
+}
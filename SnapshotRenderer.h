@@ -0,0 +1,79 @@
+/*=========================================================================
+ *
+ *  Copyright David Doria 2011 daviddoria@gmail.com
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#ifndef SnapshotRenderer_H
+#define SnapshotRenderer_H
+
+// STL
+#include <string>
+
+// VTK
+#include <vtkSmartPointer.h>
+#include <vtkType.h>
+class vtkActor;
+class vtkFloatArray;
+class vtkLookupTable;
+class vtkPNGWriter;
+class vtkPolyData;
+class vtkPolyDataMapper;
+class vtkRenderer;
+class vtkRenderWindow;
+class vtkWindowToImageFilter;
+
+/** A query point and the camera to view its comparison from. */
+struct SnapshotJob
+{
+  vtkIdType QueryId;
+
+  /** If false, the camera is reset to show the whole point cloud. */
+  bool HasCamera;
+  double Position[3];
+  double FocalPoint[3];
+  double ViewUp[3];
+
+  SnapshotJob() : QueryId(-1), HasCamera(false) {}
+};
+
+/** Render a point cloud colored by descriptor differences to PNG files in an offscreen window.
+  * The mapper, lookup table, window and writer are created once and reused for every snapshot. */
+class SnapshotRenderer
+{
+public:
+  SnapshotRenderer(const unsigned int width, const unsigned int height);
+
+  void SetPointCloud(vtkPolyData* const pointCloud);
+
+  /** Color the point cloud by 'differences', view it as described by 'job', and write it to 'fileName'.
+    * 'differences' must not be modified while this runs. */
+  void WriteSnapshot(vtkFloatArray* const differences, const SnapshotJob& job, const std::string& fileName);
+
+private:
+  vtkSmartPointer<vtkPolyData> PointCloud;
+
+  vtkSmartPointer<vtkPolyDataMapper> PointCloudMapper;
+  vtkSmartPointer<vtkActor> PointCloudActor;
+  vtkSmartPointer<vtkLookupTable> LookupTable;
+
+  vtkSmartPointer<vtkRenderer> Renderer;
+  vtkSmartPointer<vtkRenderWindow> RenderWindow;
+
+  vtkSmartPointer<vtkWindowToImageFilter> WindowToImageFilter;
+  vtkSmartPointer<vtkPNGWriter> Writer;
+};
+
+#endif